@@ -14,6 +14,8 @@ const std::string Config::TRANSACTIONS_FILE = "../data/transactions.csv";
 const std::string Config::RESERVATIONS_FILE = "../data/reservations.csv";
 const std::string Config::SETTINGS_FILE = "../data/settings.csv";
 const std::string Config::REPORTS_DIR = "../reports/";
+const std::string Config::JOURNAL_FILE_SUFFIX = ".journal";
+const std::string Config::SNAPSHOT_FILE_SUFFIX = ".bin";
 
 // 书目类型
 const std::string Config::GENRES[5] = {
@@ -59,6 +61,7 @@ Config::Config() {
 
 void Config::initializeDefaults() {
     advancedUIMode = false;         // 首次启动设置为简单 UI 样式
+    binarySnapshot = false;         // 默认只使用 CSV
     borrowPeriodDays = DEFAULT_BORROW_DAYS;
     finePerDay = FINE_PER_DAY;
     maxFine = MAX_FINE;
@@ -101,6 +104,8 @@ void Config::parseSettingsLine(const std::string& line) {
         // 应用特定设置
         if (key == "AdvancedUIMode") {
             advancedUIMode = (value == "1" || value == "true" || value == "True");
+        } else if (key == "BinarySnapshot") {
+            binarySnapshot = (value == "1" || value == "true" || value == "True");
         } else if (key == "BorrowPeriodDays") {
             try {
                 int days = std::stoi(value);
@@ -154,6 +159,7 @@ void Config::saveSettings() {
 
     // 写入设置
     ofs << "AdvancedUIMode," << (advancedUIMode ? "1" : "0") << std::endl;
+    ofs << "BinarySnapshot," << (binarySnapshot ? "1" : "0") << std::endl;
     ofs << "BorrowPeriodDays," << borrowPeriodDays << std::endl;
     ofs << "FinePerDay," << std::fixed << std::setprecision(2) << finePerDay << std::endl;
     ofs << "MaxFine," << std::fixed << std::setprecision(2) << maxFine << std::endl;
@@ -167,6 +173,10 @@ bool Config::isAdvancedUIMode() const {
     return advancedUIMode;
 }
 
+bool Config::isBinarySnapshotEnabled() const {
+    return binarySnapshot;
+}
+
 int Config::getBorrowPeriodDays() const {
     return borrowPeriodDays;
 }
@@ -187,6 +197,10 @@ void Config::setAdvancedUIMode(bool enabled) {
     advancedUIMode = enabled;
 }
 
+void Config::setBinarySnapshotEnabled(bool enabled) {
+    binarySnapshot = enabled;
+}
+
 void Config::setBorrowPeriodDays(int days) {
     if (days > 0 && days <= MAX_TOTAL_BORROW_DAYS) {
         borrowPeriodDays = days;
@@ -22,6 +22,9 @@ public:
     static const std::string SETTINGS_FILE;
     static const std::string REPORTS_DIR;
 
+    static const std::string JOURNAL_FILE_SUFFIX;   // 追加写日志文件后缀
+    static const std::string SNAPSHOT_FILE_SUFFIX;  // 二进制快照文件后缀
+
     // 书目种类
     static const std::string GENRES[5];
     static constexpr int GENRES_COUNT = 5;
@@ -39,6 +42,25 @@ public:
     static constexpr int MIN_MAX_BOOKS = 1;
     static constexpr int MAX_MAX_BOOKS = 10;
 
+    // 搜索设置
+    static constexpr int SEARCH_TOP_K = 20;                 // 容错搜索返回的结果数
+    static constexpr int SEARCH_CANDIDATE_BUDGET = 5000;    // 容错搜索由倒排表产生的候选行上限
+    static constexpr int SEARCH_RERANK_LIMIT = 500;         // 按编辑距离重排的候选行上限
+
+    // 推荐设置
+    static constexpr int RECOMMEND_LSH_TABLES = 8;          // 近似邻居查找的 LSH 表数
+    static constexpr int RECOMMEND_LSH_BITS = 20;           // 每张表的签名位数
+    static constexpr int RECOMMEND_NEIGHBOR_SEARCH_MODE = 0;    // 冷启动 KNN 的邻居查找方式: 0 精确, 1 近似 (LSH)
+
+    // 报告设置
+    static constexpr int REPORT_RECENT_DAYS = 30;           // 交易报告中近期借出/归还统计的天数
+
+    // 显示设置
+    static constexpr int PAGE_SIZE = 20;                    // 列表界面每页显示的条数
+
+    // 持久化设置
+    static constexpr int JOURNAL_COMPACT_THRESHOLD = 1000;     // 日志条数达到阈值时合并回快照
+
     // 罚款设置
     static const double FINE_PER_DAY;
     static const double MAX_FINE;
@@ -94,6 +116,7 @@ public:
 
     // 可配置的设置获取器 (可在运行时被修改)
     bool isAdvancedUIMode() const;
+    bool isBinarySnapshotEnabled() const;
     int getBorrowPeriodDays() const;
     double getFinePerDay() const;
     double getMaxFine() const;
@@ -101,6 +124,7 @@ public:
 
     // 可配置的设置设置器
     void setAdvancedUIMode(bool enabled);
+    void setBinarySnapshotEnabled(bool enabled);
     void setBorrowPeriodDays(int days);
     void setFinePerDay(double fine);
     void setMaxFine(double fine);
@@ -118,6 +142,7 @@ private:
 
     // 运行时可配置设置
     bool advancedUIMode;
+    bool binarySnapshot;            // 大表额外保存二进制快照以加速启动
     int borrowPeriodDays;
     double finePerDay;
     double maxFine;
@@ -61,8 +61,8 @@ void ensureSeedMembers(MemberManager& memberManager) {
         return;
     }
 
-    const std::string today = DateUtils::getCurrentDate();
-    const std::string expiry = DateUtils::addDays(today, 365 * 4);
+    const Date today = DateUtils::today();
+    const Date expiry = today.addDays(365 * 4);
 
     // 首次启动时的默认管理员和成员
     const Member admin(
@@ -137,9 +137,9 @@ int main() {
         TransactionManager transactionManager(Config::TRANSACTIONS_FILE);
         ReservationManager reservationManager(Config::RESERVATIONS_FILE);
         RecommendationManager recommendationManager(
-            Config::BOOKS_FILE,
-            Config::MEMBERS_FILE,
-            Config::TRANSACTIONS_FILE
+            bookManager,
+            memberManager,
+            transactionManager
         );
 
         bootstrapDefaultData(bookManager, memberManager);
@@ -2,6 +2,7 @@
 
 #include "BackupManager.h"
 #include "../config/Config.h"
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 
@@ -157,11 +158,18 @@ bool BackupManager::createBackupDirectory() {
 
 // 生成备份 ID (基于时间戳)
 std::string BackupManager::generateBackupID() {
-    time_t now = DateUtils::getCurrentTimestamp();
-    std::tm *tm = std::localtime(&now);
-    char buffer[32];
-    std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", tm);
-    return {buffer};
+    DateUtils::LocalDateTime now = DateUtils::toLocalDateTime(DateUtils::getCurrentTimestamp());
+
+    // YYYYMMDD_HHMMSS
+    std::ostringstream oss;
+    oss << std::setfill('0')
+        << std::setw(4) << now.date.year()
+        << std::setw(2) << now.date.month()
+        << std::setw(2) << now.date.day() << "_"
+        << std::setw(2) << now.hour
+        << std::setw(2) << now.minute
+        << std::setw(2) << now.second;
+    return oss.str();
 }
 
 // 复制单个文件
@@ -315,6 +323,14 @@ bool BackupManager::backupData(const std::string& backupDescription) {
                 allCopied = false;
             }
         }
+        for (const auto& datafile : OPTIONAL_DATA_FILES) {
+            std::string sourcePath = joinPath(baseDir, Config::DATA_DIR + datafile);
+            if (fileHandler.isFileExist(sourcePath) &&
+                !copyFile(sourcePath, joinPath(backupPath, datafile))) {
+                std::cerr << "复制文件失败: " << sourcePath << std::endl;
+                allCopied = false;
+            }
+        }
         if (!allCopied) {
             std::cerr << "备份失败: 一个或多个源文件缺失或复制时失败" << std::endl;
             return false;
@@ -371,6 +387,20 @@ bool BackupManager::restoreData(const std::string& backupId) {
                 return false;
             }
         }
+
+        // 备份中没有的日志必须清空, 否则旧日志会被重放到恢复后的快照上
+        for (const auto& datafile : OPTIONAL_DATA_FILES) {
+            std::string sourcePath = joinPath(backupPath, datafile);
+            std::string destinationPath = joinPath(baseDir, Config::DATA_DIR + datafile);
+            if (fileHandler.isFileExist(sourcePath)) {
+                if (!copyFile(sourcePath, destinationPath)) {
+                    std::cerr << "复制备份元文件错误: " << sourcePath << std::endl;
+                    return false;
+                }
+            } else if (fileHandler.isFileExist(destinationPath)) {
+                fileHandler.writeCSV(destinationPath, {});
+            }
+        }
         return true;
     } catch (const std::exception& e) {
         std::cerr << "恢复数据错误: " << e.what() << std::endl;
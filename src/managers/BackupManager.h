@@ -1,6 +1,7 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_BACKUPMANAGER_H
 #define LIBRARY_MANAGEMENT_SYSTEM_BACKUPMANAGER_H
 
+#include "../config/Config.h"
 #include "../utils/DateUtils.h"
 #include "../utils/FileHandler.h"
 
@@ -34,6 +35,11 @@ private:
         "reservations.csv",
         "settings.csv"
     };
+    const std::vector<std::string> OPTIONAL_DATA_FILES =                // 可能不存在的文件 (旧备份中没有)
+        {
+        "books.csv" + Config::JOURNAL_FILE_SUFFIX,
+        "transactions.csv" + Config::JOURNAL_FILE_SUFFIX
+    };
     FileHandler filehandler;
     std::vector<BackupInfo> backupInfoList;                             // 全部备份信息
     std::string baseDir;                                                // 包含 data/ 的项目根目录
@@ -1,14 +1,21 @@
 // BookManager.h 实现
 
 #include "BookManager.h"
+#include "../config/Config.h"
+#include "../utils/BinarySnapshot.h"
 #include "../utils/FileHandler.h"
+#include "../utils/TextNormalizer.h"
 #include <algorithm>
 #include <iostream>
 #include <utility>
 
 // 构造函数
 BookManager::BookManager(const std::string& filePath)
-    : filePath(filePath), fileHandler() {
+    : filePath(filePath), journalPath(filePath + Config::JOURNAL_FILE_SUFFIX),
+      snapshotPath(filePath + Config::SNAPSHOT_FILE_SUFFIX), fileHandler() {
+    // 数据已解析为对象常驻内存, 不再另存一份原始行
+    fileHandler.setCacheEnabled(filePath, false);
+    fileHandler.setCacheEnabled(journalPath, false);
 
     if (!fileHandler.isFileExist(filePath)) {
         fileHandler.createFileIfNotExist(filePath);
@@ -24,19 +31,344 @@ BookManager::BookManager(const std::string& filePath)
 void BookManager::loadFromFile() {
     books.clear();
 
-    try {
-        auto lines = fileHandler.readCSV(filePath);
+    if (loadFromSnapshot()) {
+        rebuildIndex();
+        replayJournal();
+        return;
+    }
 
-        // Skip header (line 1)
-        for (size_t i = 1; i < lines.size(); i++) {
-            if (!lines[i].empty()) {
-                books.push_back(Book::fromCSV(lines[i]));
+    try {
+        // 逐行流式解析, 字段直接从读缓冲区构造对象
+        bool isHeader = true;
+        fileHandler.forEachLine(filePath, [&](const char* begin, const char* end) {
+            // Skip header (line 1)
+            if (isHeader) {
+                isHeader = false;
+                return;
             }
-        }
+            if (begin != end) {
+                books.push_back(Book::fromCSV(begin, end));
+            }
+        });
     }
     catch (std::exception& e) {
         throw std::runtime_error("Failed to load books file: " + std::string(e.what()));
     }
+    saveSnapshot();         // 快照缺失或过期, 重新生成供下次启动使用
+    rebuildIndex();
+
+    replayJournal();
+}
+
+// 私有：助手：从二进制快照加载书籍数据
+// 列顺序与 CSV 相同; 快照损坏时清空已读数据并回退到 CSV
+bool BookManager::loadFromSnapshot() {
+    if (!Config::getInstance().isBinarySnapshotEnabled() ||
+        !BinarySnapshot::isFresh(snapshotPath, filePath)) {
+        return false;
+    }
+
+    try {
+        BinarySnapshot::Reader reader(snapshotPath);
+        if (reader.columnCount() != 8) {
+            return false;
+        }
+        // 各列类型须与 saveSnapshot 写出的一致, 否则按列读取会越界; 字符串列可为 STRING 或 DICT
+        for (size_t c = 0; c < 8; c++) {
+            BinarySnapshot::ColumnType type = reader.columnType(c);
+            bool expected = c < 5 ? (type == BinarySnapshot::STRING || type == BinarySnapshot::DICT)
+                                  : type == BinarySnapshot::INT32;
+            if (!expected) {
+                throw std::runtime_error("快照第 " + std::to_string(c) + " 列类型不符");
+            }
+        }
+
+        size_t rows = reader.rowCount();
+        books.reserve(rows);
+        for (size_t i = 0; i < rows; i++) {
+            books.emplace_back(
+                reader.stringAt(0, i).toString(),
+                reader.stringAt(1, i).toString(),
+                reader.stringAt(2, i).toString(),
+                reader.stringAt(3, i).toString(),
+                reader.stringAt(4, i).toString(),
+                reader.intAt(5, i),
+                reader.intAt(6, i),
+                reader.intAt(7, i) != 0);
+        }
+        return true;
+    } catch (std::exception& e) {
+        std::cerr << "书籍快照不可用, 改为读取 CSV: " << e.what() << std::endl;
+        books.clear();
+        return false;
+    }
+}
+
+// 私有：助手：按列写出二进制快照, 失败不影响 CSV
+void BookManager::saveSnapshot() {
+    if (!Config::getInstance().isBinarySnapshotEnabled()) {
+        return;
+    }
+
+    size_t rows = books.size();
+    std::vector<std::string> isbns, titles, authors, publishers, genres;
+    std::vector<int32_t> totals, availables, reserved;
+    isbns.reserve(rows);
+    titles.reserve(rows);
+    authors.reserve(rows);
+    publishers.reserve(rows);
+    genres.reserve(rows);
+    totals.reserve(rows);
+    availables.reserve(rows);
+    reserved.reserve(rows);
+
+    for (const auto& book : books) {
+        isbns.push_back(book.getISBN());
+        titles.push_back(book.getTitle());
+        authors.push_back(book.getAuthor());
+        publishers.push_back(book.getPublisher());
+        genres.push_back(book.getGenre());
+        totals.push_back(book.getTotalCopies());
+        availables.push_back(book.getAvailableCopies());
+        reserved.push_back(book.getIsReserved() ? 1 : 0);
+    }
+
+    try {
+        BinarySnapshot::Writer writer(rows);
+        writer.addStringColumn(isbns, false);
+        writer.addStringColumn(titles, false);
+        writer.addStringColumn(authors, true);
+        writer.addStringColumn(publishers, true);
+        writer.addStringColumn(genres, true);
+        writer.addIntColumn(totals);
+        writer.addIntColumn(availables);
+        writer.addIntColumn(reserved);
+        writer.writeTo(snapshotPath, filePath);
+    } catch (std::exception& e) {
+        std::cerr << "写入书籍快照失败: " << e.what() << std::endl;
+    }
+}
+
+// 私有：助手：依据 books 重建 ISBN 索引及全文索引
+void BookManager::rebuildIndex() {
+    keyOrderValid = false;
+    genreRevision++;
+    isbnIndex.clear();
+    isbnIndex.reserve(books.size());
+    searchKeys.clear();
+    searchKeys.resize(books.size());
+    titleIndex.clear();
+    authorIndex.clear();
+    publisherIndex.clear();
+    genreBitmaps.clear();
+    foldedGenres.clear();
+    availableBitmap.clear();
+    for (size_t i = 0; i < books.size(); i++) {
+        isbnIndex.emplace(books[i].getISBN(), i);     // 重复键保留第一条, 与线性查找一致
+        indexText(i);
+        indexFlags(i);
+    }
+}
+
+// 私有：助手：维护单本书在类型/可借位图中的位
+void BookManager::indexFlags(size_t slot) {
+    Symbol genre = books[slot].getGenreSymbol();
+    genreBitmaps[genre].set(slot);
+    if (foldedGenres.find(genre) == foldedGenres.end()) {
+        foldedGenres.emplace(genre, TextNormalizer::fold(SymbolTable::getInstance().text(genre)));
+    }
+    availableBitmap.assign(slot, books[slot].canBorrow());
+}
+
+void BookManager::unindexFlags(size_t slot) {
+    auto it = genreBitmaps.find(books[slot].getGenreSymbol());
+    if (it != genreBitmaps.end()) {
+        it->second.reset(slot);
+        if (it->second.count() == 0) {
+            foldedGenres.erase(it->first);
+            genreBitmaps.erase(it);
+        }
+    }
+    availableBitmap.reset(slot);
+}
+
+// 私有：助手：生成单本书的影子列并加入全文索引
+void BookManager::indexText(size_t slot) {
+    if (searchKeys.size() <= slot) {
+        searchKeys.resize(slot + 1);
+    }
+    const Book& book = books[slot];
+    BookSearchKeys& keys = searchKeys[slot];
+    keys.title = TextNormalizer::fold(book.getTitle());
+    keys.author = TextNormalizer::fold(book.getAuthor());
+    keys.publisher = TextNormalizer::fold(book.getPublisher());
+    keys.genre = TextNormalizer::fold(book.getGenre());
+
+    titleIndex.add(static_cast<uint32_t>(slot), keys.title);
+    authorIndex.add(static_cast<uint32_t>(slot), keys.author);
+    publisherIndex.add(static_cast<uint32_t>(slot), keys.publisher);
+}
+
+void BookManager::unindexText(size_t slot) {
+    const BookSearchKeys& keys = searchKeys[slot];
+    titleIndex.remove(static_cast<uint32_t>(slot), keys.title);
+    authorIndex.remove(static_cast<uint32_t>(slot), keys.author);
+    publisherIndex.remove(static_cast<uint32_t>(slot), keys.publisher);
+}
+
+// 私有：助手：覆盖一本书; 借还只改动册数, 文本未变时不触碰影子列与全文索引
+void BookManager::replaceBook(size_t slot, const Book& book) {
+    Book& existing = books[slot];
+    bool textChanged = existing.getTitle() != book.getTitle() ||
+                       existing.getAuthor() != book.getAuthor() ||
+                       existing.getPublisher() != book.getPublisher() ||
+                       existing.getGenreSymbol() != book.getGenreSymbol();
+    if (textChanged) {
+        unindexText(slot);
+    }
+    if (existing.getGenreSymbol() != book.getGenreSymbol()) {
+        genreRevision++;
+    }
+    unindexFlags(slot);
+    existing = book;
+    if (textChanged) {
+        indexText(slot);
+    }
+    indexFlags(slot);
+}
+
+// 私有：助手：删除一本书; 只移除该书的索引项, 其后书目在各索引中的下标减一, 不重新规范化文本
+void BookManager::eraseBook(size_t slot) {
+    unindexText(slot);
+    unindexFlags(slot);
+    Symbol isbn = books[slot].getISBNSymbol();
+    isbnIndex.erase(books[slot].getISBN());
+    books.erase(books.begin() + slot);
+    searchKeys.erase(searchKeys.begin() + slot);
+
+    for (auto& entry : isbnIndex) {
+        if (entry.second > slot) {
+            entry.second--;
+        }
+    }
+    // 索引只保留重复 ISBN 的第一条; 删除的正是它时, 其后的同号书目接替
+    for (size_t i = slot; i < books.size(); i++) {
+        if (books[i].getISBNSymbol() == isbn) {
+            isbnIndex.emplace(books[i].getISBN(), i);
+            break;
+        }
+    }
+    titleIndex.shiftDown(static_cast<uint32_t>(slot));
+    authorIndex.shiftDown(static_cast<uint32_t>(slot));
+    publisherIndex.shiftDown(static_cast<uint32_t>(slot));
+    for (auto& entry : genreBitmaps) {
+        entry.second.erase(slot);
+    }
+    availableBitmap.erase(slot);
+
+    keyOrderValid = false;
+    genreRevision++;
+}
+
+// 私有：助手：在快照之上重放日志
+// 日志格式: "U,<书籍 CSV>" 表示插入或覆盖, "D,<ISBN>" 表示删除
+// 记录以 ISBN 为键且可重复应用, 因此合并中途崩溃后重放仍然正确
+// 每条记录带校验码 (FileHandler::forEachRecord), 崩溃时写了一半的尾记录校验不通过, 重放后从文件中截掉
+void BookManager::replayJournal() {
+    journalEntries = 0;
+    if (!fileHandler.isFileExist(journalPath)) {
+        return;
+    }
+
+    auto applyRecord = [&](const char* begin, const char* end) {
+        if (end - begin < 3 || begin[1] != ',') {
+            return;
+        }
+        const char* payload = begin + 2;
+
+        if (begin[0] == 'U') {
+            Book book = Book::fromCSV(payload, end);
+            auto it = isbnIndex.find(book.getISBN());
+            if (it != isbnIndex.end()) {
+                replaceBook(it->second, book);
+            } else {
+                books.push_back(book);
+                keyOrderValid = false;
+                genreRevision++;
+                isbnIndex[book.getISBN()] = books.size() - 1;
+                indexText(books.size() - 1);
+                indexFlags(books.size() - 1);
+            }
+        } else if (begin[0] == 'D') {
+            auto it = isbnIndex.find(std::string(payload, end));
+            if (it != isbnIndex.end()) {
+                eraseBook(it->second);
+            }
+        } else {
+            return;
+        }
+        journalEntries++;
+    };
+
+    try {
+        fileHandler.forEachRecord(journalPath, applyRecord);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to load books journal: " + std::string(e.what()));
+    }
+}
+
+// 私有：助手：追加一条日志记录, 达到阈值则合并; 组提交期间只暂存
+void BookManager::appendJournal(char op, const std::string& payload) {
+    if (groupDepth > 0) {
+        pendingJournal.push_back(std::string(1, op) + "," + payload);
+        return;
+    }
+
+    try {
+        fileHandler.appendRecord(journalPath, std::string(1, op) + "," + payload);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to append books journal: " + std::string(e.what()));
+    }
+
+    if (++journalEntries >= Config::JOURNAL_COMPACT_THRESHOLD) {
+        compactJournal();
+    }
+}
+
+// 组提交: 可嵌套, 只有最外层结束时才落盘
+void BookManager::beginGroupCommit() {
+    groupDepth++;
+}
+
+void BookManager::endGroupCommit() {
+    if (groupDepth == 0 || --groupDepth > 0 || pendingJournal.empty()) {
+        return;
+    }
+
+    std::vector<std::string> records;
+    records.swap(pendingJournal);
+    try {
+        fileHandler.appendRecords(journalPath, records);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to append books journal: " + std::string(e.what()));
+    }
+
+    journalEntries += static_cast<int>(records.size());
+    if (journalEntries >= Config::JOURNAL_COMPACT_THRESHOLD) {
+        compactJournal();
+    }
+}
+
+// 将日志合并回快照: 先写快照再清空日志
+void BookManager::compactJournal() {
+    saveToFile();
+    try {
+        fileHandler.writeCSV(journalPath, {});
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to truncate books journal: " + std::string(e.what()));
+    }
+    journalEntries = 0;
+    pendingJournal.clear();        // 暂存记录已包含在新快照中
 }
 
 // 私有：助手：向文件保存书籍数据
@@ -51,16 +383,25 @@ void BookManager::saveToFile() {
     }
 
     try {
-        fileHandler.writeCSV(filePath, lines);
+        fileHandler.writeCSV(filePath, std::move(lines));
     } catch (std::exception& e) {
         throw std::runtime_error("Failed to save books file: " + std::string(e.what()));
     }
+    saveSnapshot();
 }
 
-// 私有：辅助：检查自动保存标志决定是否需要保存
-void BookManager::saveIfNeeded() {
+// 私有：辅助：检查自动保存标志决定是否需要记录日志
+// 只记录被修改的一行, 借还一次的写入量与馆藏规模无关
+// 批量操作期间不写日志, 由批量结束时的合并统一落盘
+void BookManager::logUpsert(const Book& book) {
     if (autoSave) {
-        saveToFile();
+        appendJournal('U', book.toCSV());
+    }
+}
+
+void BookManager::logDelete(const std::string& isbn) {
+    if (autoSave) {
+        appendJournal('D', isbn);
     }
 }
 
@@ -71,18 +412,22 @@ bool BookManager::addBook(const Book& book) {
         return false;
     }
     books.push_back(book);
-    saveIfNeeded();
+    keyOrderValid = false;
+    genreRevision++;
+    isbnIndex[book.getISBN()] = books.size() - 1;
+    indexText(books.size() - 1);
+    indexFlags(books.size() - 1);
+    logUpsert(book);
     return true;
 }
 
 // 以 ISBN 删除一本书
 bool BookManager::deleteBook(const std::string& isbn) {
-    auto it = std::find_if(books.begin(), books.end(),
-        [&](const Book& book) { return book.getISBN() == isbn; });
+    auto it = isbnIndex.find(isbn);
 
-    if (it != books.end()) {
-        books.erase(it);
-        saveIfNeeded();
+    if (it != isbnIndex.end()) {
+        eraseBook(it->second);
+        logDelete(isbn);
         return true;
     }
     return false;
@@ -90,34 +435,35 @@ bool BookManager::deleteBook(const std::string& isbn) {
 
 // 更新现有图书
 bool BookManager::updateBook(const Book& book) {
-    Book *existingBook = findBookByISBN(book.getISBN());
+    auto it = isbnIndex.find(book.getISBN());
 
-    if (existingBook == nullptr) {
+    if (it == isbnIndex.end()) {
         return false;
     }
-    *existingBook = book;
-    saveIfNeeded();
+    replaceBook(it->second, book);
+    logUpsert(books[it->second]);
     return true;
 }
 
 // 以 ISBN 查找一本书
 Book* BookManager::findBookByISBN(const std::string &isbn) {
-    for (auto& book : books) {
-        if (book.getISBN() == isbn) {
-            return &book;
-        }
+    auto it = isbnIndex.find(isbn);
+    if (it == isbnIndex.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return &books[it->second];
 }
 
 // 书籍查找模板
 // matchMode = 0 --> 精确查找 (区分大小写) (默认)
-// matchMode = 1 --> 模糊查找 (统一大小写)
+// matchMode = 1 --> 模糊查找 (与影子列中预先规范化的形式比较, 不区分大小写与全半角)
 template<typename Getter>
 std::vector<const Book*> findByField(
     const std::vector<Book>& books,
+    const std::vector<BookSearchKeys>& searchKeys,
     const std::string& key,
     Getter getter,
+    std::string BookSearchKeys::*foldedField,
     int matchMode = 0
     ) {
         if (matchMode != 0 && matchMode != 1) {
@@ -134,15 +480,45 @@ std::vector<const Book*> findByField(
             }
         }
         else {
-            std::string lowerKey = key;
-            std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(), ::tolower);
+            std::string foldedKey = TextNormalizer::fold(key);
 
-            for (const auto& book : books) {
-                std::string bookKey = (book.*getter)();
-                std::transform(bookKey.begin(), bookKey.end(), bookKey.begin(), ::tolower);
+            for (size_t i = 0; i < books.size(); i++) {
+                if ((searchKeys[i].*foldedField).find(foldedKey) != std::string::npos)
+                    results.push_back(&books[i]);
+            }
+        }
+        return results;
+}
 
-                if (bookKey.find(lowerKey) != std::string::npos)
-                    results.push_back(&book);
+// 带全文索引的书籍查找: 由三元组索引得到候选, 再逐个核对
+// 查询过短无法使用索引时退回 findByField 全表扫描, 结果与其完全一致
+template<typename Getter>
+std::vector<const Book*> findByIndexedField(
+    const std::vector<Book>& books,
+    const std::vector<BookSearchKeys>& searchKeys,
+    const TrigramIndex& index,
+    const std::string& key,
+    Getter getter,
+    std::string BookSearchKeys::*foldedField,
+    int matchMode = 0
+    ) {
+        if (matchMode != 0 && matchMode != 1) {
+            throw std::runtime_error("无效匹配码");
+        }
+
+        std::string foldedKey = TextNormalizer::fold(key);
+
+        std::vector<uint32_t> slots;
+        if (!index.candidates(foldedKey, slots)) {
+            return findByField(books, searchKeys, key, getter, foldedField, matchMode);
+        }
+
+        std::vector<const Book*> results;
+        for (uint32_t slot : slots) {
+            bool matched = matchMode == 0 ? (books[slot].*getter)() == key
+                                          : (searchKeys[slot].*foldedField).find(foldedKey) != std::string::npos;
+            if (matched) {
+                results.push_back(&books[slot]);
             }
         }
         return results;
@@ -150,33 +526,302 @@ std::vector<const Book*> findByField(
 
 // 以标题查找书
 std::vector<const Book*> BookManager::findByTitle(const std::string& title, int matchMode) const {
-    return findByField(books, title,&Book::getTitle , matchMode);
+    return findByIndexedField(books, searchKeys, titleIndex, title, &Book::getTitle, &BookSearchKeys::title, matchMode);
 }
 
 // 以作者查找书
 std::vector<const Book*> BookManager::findByAuthor(const std::string& author, int matchMode) const {
-    return findByField(books, author, &Book::getAuthor, matchMode);
+    return findByIndexedField(books, searchKeys, authorIndex, author, &Book::getAuthor, &BookSearchKeys::author, matchMode);
 }
 
 // 以出版社查找书
 std::vector<const Book*> BookManager::findByPublisher(const std::string& publisher, int matchMode) const {
-    return findByField(books, publisher, &Book::getPublisher, matchMode);
+    return findByIndexedField(books, searchKeys, publisherIndex, publisher, &Book::getPublisher,
+                              &BookSearchKeys::publisher, matchMode);
 }
 
 // 以类型查找书
+// 类型只有少数几种: 精确匹配直接取该类型的位图, 模糊匹配合并名称匹配的各类型位图
 std::vector<const Book*> BookManager::findByGenre(const std::string& genre, int matchMode) const {
-    return findByField(books, genre, &Book::getGenre, matchMode);
+    if (matchMode != 0 && matchMode != 1) {
+        throw std::runtime_error("无效匹配码");
+    }
+
+    Bitmap matched;
+    if (!genreBitmapFor(genre, matchMode, matched)) {
+        return std::vector<const Book*>();
+    }
+    return booksIn(matched);
+}
+
+// 组合查询条件的链式设置
+BookQuery& BookQuery::whereTitle(const std::string& value, int matchMode) {
+    title.enabled = true;
+    title.value = value;
+    title.matchMode = matchMode;
+    return *this;
+}
+
+BookQuery& BookQuery::whereAuthor(const std::string& value, int matchMode) {
+    author.enabled = true;
+    author.value = value;
+    author.matchMode = matchMode;
+    return *this;
+}
+
+BookQuery& BookQuery::wherePublisher(const std::string& value, int matchMode) {
+    publisher.enabled = true;
+    publisher.value = value;
+    publisher.matchMode = matchMode;
+    return *this;
+}
+
+BookQuery& BookQuery::whereGenre(const std::string& value, int matchMode) {
+    genre.enabled = true;
+    genre.value = value;
+    genre.matchMode = matchMode;
+    return *this;
+}
+
+BookQuery& BookQuery::onlyAvailable(bool enable) {
+    availableOnly = enable;
+    return *this;
+}
+
+// 组合查询
+// 1. 类型与可借条件由位图按位与得到过滤位图
+// 2. 为每个文本条件预先折叠查询值, 并用三元组索引估计其命中数
+// 3. 过滤位图与各索引中估计命中最少者产生候选行, 都不可用时全表扫描
+// 4. 候选行依次检查: 过滤位图 -> 精确条件 -> 子串条件, 全部满足才交给 onMatch
+void BookManager::forEachMatch(const BookQuery& query, const std::function<bool(const Book&)>& onMatch) const {
+    struct Condition {
+        const BookQuery::TextCondition* condition;
+        std::string folded;
+        const std::string& (Book::*getter)() const;
+        std::string BookSearchKeys::*keyField;
+        const TrigramIndex* index;
+    };
+
+    const Condition all[] = {
+        {&query.title, "", &Book::getTitle, &BookSearchKeys::title, &titleIndex},
+        {&query.author, "", &Book::getAuthor, &BookSearchKeys::author, &authorIndex},
+        {&query.publisher, "", &Book::getPublisher, &BookSearchKeys::publisher, &publisherIndex}
+    };
+
+    std::vector<Condition> conditions;
+    for (const auto& candidate : all) {
+        if (!candidate.condition->enabled) {
+            continue;
+        }
+        if (candidate.condition->matchMode != 0 && candidate.condition->matchMode != 1) {
+            throw std::runtime_error("无效匹配码");
+        }
+        conditions.push_back(candidate);
+        conditions.back().folded = TextNormalizer::fold(candidate.condition->value);
+    }
+    // 精确条件比较代价低且更有选择性, 放在前面
+    std::stable_sort(conditions.begin(), conditions.end(), [](const Condition& a, const Condition& b) {
+        return a.condition->matchMode < b.condition->matchMode;
+    });
+
+    bool filtered = query.genre.enabled || query.availableOnly;
+    Bitmap filter;
+    if (query.genre.enabled) {
+        if (query.genre.matchMode != 0 && query.genre.matchMode != 1) {
+            throw std::runtime_error("无效匹配码");
+        }
+        if (!genreBitmapFor(query.genre.value, query.genre.matchMode, filter)) {
+            return;
+        }
+        if (query.availableOnly) {
+            filter &= availableBitmap;
+        }
+    } else if (query.availableOnly) {
+        filter = availableBitmap;
+    }
+
+    const Condition* driver = nullptr;
+    size_t driverEstimate = filtered ? filter.count() : books.size();
+    for (const auto& condition : conditions) {
+        size_t estimate = condition.index->estimate(condition.folded);
+        if (estimate < driverEstimate) {
+            driver = &condition;
+            driverEstimate = estimate;
+        }
+    }
+
+    auto matches = [&](size_t slot) {
+        if (filtered && !filter.test(slot)) {
+            return false;
+        }
+        const Book& book = books[slot];
+        for (const auto& condition : conditions) {
+            bool matched = condition.condition->matchMode == 0
+                ? (book.*condition.getter)() == condition.condition->value
+                : (searchKeys[slot].*condition.keyField).find(condition.folded) != std::string::npos;
+            if (!matched) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (driver != nullptr) {
+        std::vector<uint32_t> slots;
+        driver->index->candidates(driver->folded, slots);
+        for (uint32_t slot : slots) {
+            if (matches(slot) && !onMatch(books[slot])) {
+                return;
+            }
+        }
+        return;
+    }
+
+    if (filtered) {
+        filter.forEach([&](size_t slot) {
+            return !matches(slot) || onMatch(books[slot]);
+        });
+        return;
+    }
+
+    for (size_t slot = 0; slot < books.size(); slot++) {
+        if (matches(slot) && !onMatch(books[slot])) {
+            return;
+        }
+    }
+}
+
+std::vector<const Book*> BookManager::findBooks(const BookQuery& query, size_t limit) const {
+    std::vector<const Book*> results;
+    if (limit == 0) {
+        return results;
+    }
+    forEachMatch(query, [&](const Book& book) {
+        results.push_back(&book);
+        return results.size() < limit;
+    });
+    return results;
+}
+
+// 容错搜索
+// 1. 由书名/作者的三元组索引统计与 query 共有的三元组数, 得到有限个候选
+// 2. 取共有数最多的候选, 计算 query 与书名/作者任一子串的编辑距离
+// 3. 距离在容许的错别字数以内者按 (距离, 共有数, 原顺序) 排序, 取前 topK
+// 过短的 query 无三元组可用, 退回子串匹配
+std::vector<const Book*> BookManager::findBestMatches(const std::string& query, size_t topK) const {
+    std::vector<const Book*> results;
+    std::string foldedQuery = TextNormalizer::fold(query);
+    if (foldedQuery.empty() || topK == 0) {
+        return results;
+    }
+
+    if (foldedQuery.size() < TrigramIndex::MIN_QUERY_LENGTH) {
+        for (size_t i = 0; i < books.size() && results.size() < topK; i++) {
+            if (searchKeys[i].title.find(foldedQuery) != std::string::npos ||
+                searchKeys[i].author.find(foldedQuery) != std::string::npos) {
+                results.push_back(&books[i]);
+            }
+        }
+        return results;
+    }
+
+    // 书名与作者各自计数, 取较大者
+    std::unordered_map<uint32_t, int> titleCounts;
+    std::unordered_map<uint32_t, int> authorCounts;
+    titleIndex.countShared(foldedQuery, Config::SEARCH_CANDIDATE_BUDGET, titleCounts);
+    authorIndex.countShared(foldedQuery, Config::SEARCH_CANDIDATE_BUDGET, authorCounts);
+
+    std::unordered_map<uint32_t, int> counts;
+    counts.swap(titleCounts);
+    for (const auto& entry : authorCounts) {
+        int& count = counts[entry.first];
+        count = std::max(count, entry.second);
+    }
+
+    std::vector<std::pair<uint32_t, int>> candidates(counts.begin(), counts.end());
+    auto byCount = [](const std::pair<uint32_t, int>& a, const std::pair<uint32_t, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    size_t rerank = std::min(candidates.size(), static_cast<size_t>(Config::SEARCH_RERANK_LIMIT));
+    std::partial_sort(candidates.begin(), candidates.begin() + rerank, candidates.end(), byCount);
+    candidates.resize(rerank);
+
+    std::vector<uint32_t> pattern;
+    std::vector<uint32_t> text;
+    TextNormalizer::toCodePoints(foldedQuery, pattern);
+    size_t maxTypos = std::max<size_t>(1, pattern.size() / 4);
+
+    struct Scored {
+        size_t distance;
+        int shared;
+        uint32_t slot;
+    };
+    std::vector<Scored> scored;
+    for (const auto& candidate : candidates) {
+        const BookSearchKeys& keys = searchKeys[candidate.first];
+        TextNormalizer::toCodePoints(keys.title, text);
+        size_t distance = TextNormalizer::substringEditDistance(pattern, text, maxTypos);
+        if (distance > 0) {
+            TextNormalizer::toCodePoints(keys.author, text);
+            distance = std::min(distance, TextNormalizer::substringEditDistance(pattern, text, maxTypos));
+        }
+        if (distance <= maxTypos) {
+            scored.push_back(Scored{distance, candidate.second, candidate.first});
+        }
+    }
+
+    size_t count = std::min(scored.size(), topK);
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(),
+        [](const Scored& a, const Scored& b) {
+            if (a.distance != b.distance) return a.distance < b.distance;
+            if (a.shared != b.shared) return a.shared > b.shared;
+            return a.slot < b.slot;
+        });
+
+    results.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        results.push_back(&books[scored[i].slot]);
+    }
+    return results;
 }
 
 // 查找可用书目
 std::vector<const Book*> BookManager::findAvailableBooks() const {
-    std::vector<const Book*> results;
+    return booksIn(availableBitmap);
+}
 
-    for (const auto& book : books) {
-        if (book.canBorrow()) {
-            results.push_back(&book);
+// 私有：助手：合并与 genre 匹配的各类型位图到 out, 无匹配类型时返回 false
+bool BookManager::genreBitmapFor(const std::string& genre, int matchMode, Bitmap& out) const {
+    out.clear();
+    if (matchMode == 0) {
+        auto it = genreBitmaps.find(SymbolTable::getInstance().find(genre));
+        if (it == genreBitmaps.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    // 各类型名已在建索引时规范化, 每次查询只规范化 genre 本身
+    std::string foldedGenre = TextNormalizer::fold(genre);
+    bool any = false;
+    for (const auto& entry : foldedGenres) {
+        if (entry.second.find(foldedGenre) != std::string::npos) {
+            out |= genreBitmaps.find(entry.first)->second;
+            any = true;
         }
     }
+    return any;
+}
+
+// 私有：助手：按位图中的置位顺序取出书目
+std::vector<const Book*> BookManager::booksIn(const Bitmap& bitmap) const {
+    std::vector<const Book*> results;
+    results.reserve(bitmap.count());
+    bitmap.forEach([&](size_t slot) {
+        results.push_back(&books[slot]);
+        return true;
+    });
     return results;
 }
 
@@ -193,7 +838,8 @@ bool BookManager::borrowBook(const std::string& isbn) {         // -> Transactio
     }
 
     book->borrowBook();
-    saveIfNeeded();
+    availableBitmap.assign(isbnIndex[isbn], book->canBorrow());
+    logUpsert(*book);
     return true;
 }
 
@@ -206,12 +852,13 @@ bool BookManager::returnBook(const std::string& isbn) {         // -> Transactio
     }
 
     book->returnBook();
-    saveIfNeeded();
+    availableBitmap.assign(isbnIndex[isbn], book->canBorrow());
+    logUpsert(*book);
     return true;
 }
 
 // 获取所有书目
-std::vector<Book> BookManager::getAllBooks() const {
+const std::vector<Book>& BookManager::getAllBooks() const {
     return books;
 }
 
@@ -222,13 +869,11 @@ int BookManager::getTotalBooks() const {
 
 // 获取可用书目数量
 int BookManager::getAvailableCount() const {
-    int count = 0;
-    for (const auto& book : books) {
-        if (book.canBorrow()) {
-            count++;
-        }
-    }
-    return count;
+    return static_cast<int>(availableBitmap.count());
+}
+
+uint64_t BookManager::getGenreRevision() const {
+    return genreRevision;
 }
 
 // 重新加载文件
@@ -243,8 +888,42 @@ void BookManager::clearCache() {
 
 // 检查如果 ISBN 存在
 bool BookManager::isISBNExists(const std::string& isbn) const {
-    return std::find_if(books.begin(), books.end(),
-        [&](const Book& book) { return book.getISBN() == isbn; }) != books.end();
+    return isbnIndex.find(isbn) != isbnIndex.end();
+}
+
+// 私有：助手：取分页用的排序下标
+const std::vector<size_t>* BookManager::orderFor(int sortOrder) const {
+    if (sortOrder != 0 && sortOrder != 1) {
+        throw std::runtime_error("无效排序码");
+    }
+    if (sortOrder == 0) {
+        return nullptr;
+    }
+    if (!keyOrderValid) {
+        Pagination::sortByKey(books, &Book::getISBN, keyOrder);
+        keyOrderValid = true;
+    }
+    return &keyOrder;
+}
+
+// 按偏移分页
+Page<Book> BookManager::getBooksPage(size_t offset, size_t limit, int sortOrder) const {
+    return Pagination::makePage(books, orderFor(sortOrder), offset, limit, &Book::getISBN);
+}
+
+// 按游标分页: 存储顺序时由主键索引定位游标, 主键顺序时二分查找
+Page<Book> BookManager::getBooksPageAfter(const std::string& cursor, size_t limit, int sortOrder) const {
+    const std::vector<size_t>* order = orderFor(sortOrder);
+    size_t start = 0;
+    if (!cursor.empty()) {
+        if (order != nullptr) {
+            start = Pagination::positionAfter(books, *order, cursor, &Book::getISBN);
+        } else {
+            auto it = isbnIndex.find(cursor);
+            start = it == isbnIndex.end() ? books.size() : it->second + 1;
+        }
+    }
+    return Pagination::makePage(books, order, start, limit, &Book::getISBN);
 }
 
 // 批量操作 (RAII)
@@ -273,7 +952,7 @@ BookManager::BatchOperation::~BatchOperation() {
     }
 
     try {
-        bookManager->saveToFile();
+        bookManager->compactJournal();
         bookManager->setAutoSave(originalAutoSave);
     } catch (...) {
         std::cerr << "在批量操作过程中尝试保存书籍时出错" << std::endl;
@@ -2,14 +2,68 @@
 #define LIBRARY_MANAGEMENT_SYSTEM_BOOKMANAGER_H
 
 #include "../models/Book.h"
+#include "../config/Config.h"
+#include "../utils/Bitmap.h"
 #include "../utils/FileHandler.h"
+#include "../utils/Pagination.h"
+#include "../utils/TrigramIndex.h"
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+// 书籍可搜索字段的规范化形式 (影子列), 加载/修改时由 TextNormalizer 生成一次
+struct BookSearchKeys {
+    std::string title;
+    std::string author;
+    std::string publisher;
+    std::string genre;
+};
+
+// 书籍组合查询: 各条件之间为 "与", 未设置的条件不参与过滤
+// matchMode 含义与 findByTitle 等相同: 0 精确匹配, 1 模糊 (子串) 匹配
+struct BookQuery {
+    struct TextCondition {
+        bool enabled = false;
+        std::string value;
+        int matchMode = 0;
+    };
+
+    TextCondition title;
+    TextCondition author;
+    TextCondition publisher;
+    TextCondition genre;
+    bool availableOnly = false;
+
+    // 链式设置
+    BookQuery& whereTitle(const std::string& value, int matchMode = 0);
+    BookQuery& whereAuthor(const std::string& value, int matchMode = 0);
+    BookQuery& wherePublisher(const std::string& value, int matchMode = 0);
+    BookQuery& whereGenre(const std::string& value, int matchMode = 0);
+    BookQuery& onlyAvailable(bool enable = true);
+};
+
 class BookManager {
 private:
     std::vector<Book> books;
+    std::unordered_map<std::string, size_t> isbnIndex;     // ISBN -> books 下标
+    mutable std::vector<size_t> keyOrder;                   // 按ISBN排序的下标, 分页时按需生成
+    mutable bool keyOrderValid = false;
+    uint64_t genreRevision = 0;     // 书目增删或类型变更时递增, 借还不变
+    std::vector<BookSearchKeys> searchKeys;                // 与 books 一一对应
+    TrigramIndex titleIndex;        // 书名/作者/出版社规范化形式的三元组倒排索引, 用于子串搜索
+    TrigramIndex authorIndex;
+    TrigramIndex publisherIndex;
+    std::unordered_map<Symbol, Bitmap> genreBitmaps;        // 类型 (驻留句柄) -> 该类型书目的位图
+    std::unordered_map<Symbol, std::string> foldedGenres;   // 类型 -> 规范化后的类型名, 与 genreBitmaps 同增删, 供模糊匹配
+    Bitmap availableBitmap;                                 // 可借 (canBorrow) 书目的位图
     std::string filePath;
+    std::string journalPath;        // 追加写日志 (快照 + 日志尾 = 当前数据)
+    std::string snapshotPath;       // 可选的二进制列式快照, 与 CSV 内容一致时优先加载
+    int journalEntries = 0;         // 自上次合并以来的日志条数
+    int groupDepth = 0;             // 组提交嵌套层数, 大于 0 时日志记录暂存于 pendingJournal
+    std::vector<std::string> pendingJournal;
     FileHandler fileHandler;
 
     // 数据持久化
@@ -19,14 +73,42 @@ private:
     // 助手：向文件中保存书籍数据
     void saveToFile();
 
+    // 助手：二进制快照可用时从快照加载, 否则返回 false
+    bool loadFromSnapshot();
+    void saveSnapshot();
+
+    // 助手：依据 books 重建 ISBN 索引及全文索引
+    void rebuildIndex();
+
+    // 助手：维护单本书的影子列与全文索引, 修改可搜索字段前先移除, 修改后再加入
+    void indexText(size_t slot);
+    void unindexText(size_t slot);
+    // 助手：维护单本书在类型/可借位图中的位, 修改类型前先移除
+    void indexFlags(size_t slot);
+    void unindexFlags(size_t slot);
+    void replaceBook(size_t slot, const Book& book);
+    void eraseBook(size_t slot);    // 删除一本书并就地调整各索引中其后书目的下标
+
+    // 助手：位图查询
+    bool genreBitmapFor(const std::string& genre, int matchMode, Bitmap& out) const;
+    std::vector<const Book*> booksIn(const Bitmap& bitmap) const;
+
+    // 日志: 每次变更只追加被修改的那一行, 达到阈值后合并回快照
+    void replayJournal();
+    void appendJournal(char op, const std::string& payload);
+
     // 用于批量操作
     bool autoSave = true;
     void setAutoSave(bool enable = true);
     bool isAutoSaveEnabled() const;
 
-    // 助手：检查自动保存标志决定是否需要保存
-    void saveIfNeeded();
+    // 助手：检查自动保存标志决定是否需要记录日志
+    void logUpsert(const Book& book);
+    void logDelete(const std::string& isbn);
+
 
+    // 助手：取分页用的排序下标, 存储顺序时返回 nullptr
+    const std::vector<size_t>* orderFor(int sortOrder) const;
 
 public:
     // 构造函数
@@ -44,20 +126,38 @@ public:
     std::vector<const Book*> findByPublisher(const std::string& publisher, int matchMode = 0) const;
     std::vector<const Book*> findByGenre(const std::string& genre, int matchMode = 0) const;
     std::vector<const Book*> findAvailableBooks() const;
+    // 组合查询: 选择估计命中最少的索引产生候选, 逐个检查其余条件后交给 onMatch, 不生成中间结果
+    // onMatch 返回 false 时停止; 按 books 中的顺序产出
+    void forEachMatch(const BookQuery& query, const std::function<bool(const Book&)>& onMatch) const;
+    std::vector<const Book*> findBooks(const BookQuery& query, size_t limit = SIZE_MAX) const;
+
+    // 容错搜索: 在书名和作者中查找 query, 允许少量错别字, 按相关度返回前 topK 本
+    std::vector<const Book*> findBestMatches(const std::string& query, size_t topK = Config::SEARCH_TOP_K) const;
 
     // 借/还操作
     bool borrowBook(const std::string& isbn);
     bool returnBook(const std::string& isbn);
 
     // 获取器
-    std::vector<Book> getAllBooks() const;
+    const std::vector<Book>& getAllBooks() const;
     int getTotalBooks() const;
     int getAvailableCount() const;
+    uint64_t getGenreRevision() const;      // 供推荐器判断 ISBN -> 类型映射是否需要重建
     // std::vector<Book*> getAvailableBooks() const;
 
+    // 分页 (sortOrder: 0 存储顺序, 1 按ISBN升序), 只返回指针, 不复制书目
+    Page<Book> getBooksPage(size_t offset, size_t limit, int sortOrder = 0) const;
+    // 键集分页: 从游标 (上一页的 nextCursor) 之后开始, 游标为空时从头开始; 游标已失效时返回空页
+    Page<Book> getBooksPageAfter(const std::string& cursor, size_t limit, int sortOrder = 0) const;
+
     // 实用方法
     void reload();          // 重新加载文件
     void clearCache();      // 清除文件处理器缓存
+    void compactJournal();  // 将日志合并回 CSV 快照并清空日志
+
+    // 组提交 (由 UnitOfWork 调用): 开始后日志只暂存在内存, 最外层结束时一次写出并同步
+    void beginGroupCommit();
+    void endGroupCommit();
     bool isISBNExists(const std::string& isbn) const;
 
     // 批量操作 (RAII)
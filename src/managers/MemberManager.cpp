@@ -2,13 +2,17 @@
 
 #include "MemberManager.h"
 #include "../utils/FileHandler.h"
+#include "../utils/TextNormalizer.h"
 #include "../authentication/auth.h"
 #include <algorithm>
 #include <iostream>
+#include <utility>
 
 // 构造函数
 MemberManager::MemberManager(const std::string& filePath)
     : filePath(filePath), fileHandler() {
+    // 数据已解析为对象常驻内存, 不再另存一份原始行
+    fileHandler.setCacheEnabled(filePath, false);
 
     if (!fileHandler.isFileExist(filePath)) {
         fileHandler.createFileIfNotExist(filePath);
@@ -23,20 +27,49 @@ MemberManager::MemberManager(const std::string& filePath)
 // 私有: 助手: 从文件加载成员数据
 void MemberManager::loadFromFile() {
     members.clear();
+    rejectedLines.clear();
 
     try {
-        auto lines = fileHandler.readCSV(filePath);
-
-        // Skip header (line 1)
-        for (size_t i = 1; i < lines.size(); i++) {
-            if (!lines[i].empty()) {
-                members.push_back(Member::fromCSV(lines[i]));
+        // 逐行流式解析, 字段直接从读缓冲区构造对象
+        bool isHeader = true;
+        size_t lineNumber = 0;
+        fileHandler.forEachLine(filePath, [&](const char* begin, const char* end) {
+            lineNumber++;
+            // Skip header (line 1)
+            if (isHeader) {
+                isHeader = false;
+                return;
             }
-        }
+            if (begin == end) {
+                return;
+            }
+            // 无法解析的行 (如日期格式错误) 不载入, 保留原文, 避免保存时被改写或丢失
+            try {
+                members.push_back(Member::fromCSV(begin, end));
+            } catch (std::exception& e) {
+                std::cerr << "跳过无法解析的会员记录 (第 " << lineNumber << " 行): " << e.what() << std::endl;
+                rejectedLines.emplace_back(begin, end);
+            }
+        });
     }
     catch (std::exception& e) {
         throw std::runtime_error("Failed to load members file: " + std::string(e.what()));
     }
+    rebuildIndex();
+}
+
+// 私有: 助手: 依据 members 重建 MemberID 索引及姓名影子列
+void MemberManager::rebuildIndex() {
+    keyOrderValid = false;
+    rosterRevision++;
+    idIndex.clear();
+    idIndex.reserve(members.size());
+    foldedNames.clear();
+    foldedNames.reserve(members.size());
+    for (size_t i = 0; i < members.size(); i++) {
+        idIndex.emplace(members[i].getMemberID(), i);     // 重复键保留第一条, 与线性查找一致
+        foldedNames.push_back(TextNormalizer::fold(members[i].getName()));
+    }
 }
 
 // 私有: 助手: 将成员数据保存到文件
@@ -49,9 +82,10 @@ void MemberManager::saveToFile() {
     for (const auto& member : members) {
         lines.push_back(member.toCSV());
     }
+    lines.insert(lines.end(), rejectedLines.begin(), rejectedLines.end());     // 无法解析的行原样写回
 
     try {
-        fileHandler.writeCSV(filePath, lines);
+        fileHandler.writeCSV(filePath, std::move(lines));
     } catch (std::exception& e) {
         throw std::runtime_error("Failed to save members file: " + std::string(e.what()));
     }
@@ -59,9 +93,27 @@ void MemberManager::saveToFile() {
 
 // 私有: 辅助: 检查自动保存标志决定是否需要保存
 void MemberManager::saveIfNeeded() {
-    if (autoSave) {
-        saveToFile();
+    if (!autoSave) {
+        return;
     }
+    if (groupDepth > 0) {
+        groupDirty = true;
+        return;
+    }
+    saveToFile();
+}
+
+// 组提交: 可嵌套, 只有最外层结束时才落盘
+void MemberManager::beginGroupCommit() {
+    groupDepth++;
+}
+
+void MemberManager::endGroupCommit() {
+    if (groupDepth == 0 || --groupDepth > 0 || !groupDirty) {
+        return;
+    }
+    groupDirty = false;
+    saveToFile();
 }
 
 // 新增一位会员
@@ -71,17 +123,20 @@ bool MemberManager::addMember(const Member& member) {
         return false;
     }
     members.push_back(member);
+    keyOrderValid = false;
+    idIndex[member.getMemberID()] = members.size() - 1;
+    foldedNames.push_back(TextNormalizer::fold(member.getName()));
     saveIfNeeded();
     return true;
 }
 
 // 以 MemberID 删除一位会员
 bool MemberManager::deleteMember(const std::string& MemberID) {
-    auto it = std::find_if(members.begin(), members.end(),
-        [&](const Member& member) { return member.getMemberID() == MemberID; });
+    auto it = idIndex.find(MemberID);
 
-    if (it != members.end()) {
-        members.erase(it);
+    if (it != idIndex.end()) {
+        members.erase(members.begin() + it->second);
+        rebuildIndex();     // 删除后其后会员下标前移
         saveIfNeeded();
         return true;
     }
@@ -90,24 +145,27 @@ bool MemberManager::deleteMember(const std::string& MemberID) {
 
 // 更新现有会员
 bool MemberManager::updateMember(const Member& member) {
-    Member *existingMember = findMemberByID(member.getMemberID());
+    auto it = idIndex.find(member.getMemberID());
 
-    if (existingMember == nullptr) {
+    if (it == idIndex.end()) {
         return false;
     }
-    *existingMember = member;
+    if (members[it->second].getPreferenceSymbols() != member.getPreferenceSymbols()) {
+        rosterRevision++;
+    }
+    members[it->second] = member;
+    foldedNames[it->second] = TextNormalizer::fold(member.getName());
     saveIfNeeded();
     return true;
 }
 
 // 以 MemberID 查找一位会员
 Member* MemberManager::findMemberByID(const std::string &MemberID) {
-    for (auto& member : members) {
-        if (member.getMemberID() == MemberID) {
-            return &member;
-        }
+    auto it = idIndex.find(MemberID);
+    if (it == idIndex.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return &members[it->second];
 }
 
 // 会员查找模板
@@ -137,8 +195,9 @@ std::vector<const Member*> findByField(
             std::string lowerKey = key;
             std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(), ::tolower);
 
+            std::string memberKey;          // 复用同一缓冲区, 逐行只拷贝不重新分配
             for (const auto& member : members) {
-                std::string memberKey = (member.*getter)();
+                memberKey.assign((member.*getter)());
                 std::transform(memberKey.begin(), memberKey.end(), memberKey.begin(), ::tolower);
 
                 if (memberKey.find(lowerKey) != std::string::npos)
@@ -148,9 +207,61 @@ std::vector<const Member*> findByField(
         return results;
 }
 
+// 会员日期字段查找模板
+// matchMode = 0 --> 精确匹配, 查询日期只解析一次, 之后比较天数
+// matchMode = 1 --> 模糊匹配, 在 "YYYY-MM-DD" 形式中查找子串 (如 "2024-03")
+template<typename Getter>
+std::vector<const Member*> findByDateField(
+    const std::vector<Member>& members,
+    const std::string& key,
+    Getter getter,
+    int matchMode = 0
+    ) {
+        if (matchMode != 0 && matchMode != 1) {
+            throw std::runtime_error("匹配码无效");
+        }
+
+        std::vector<const Member*> results;
+
+        if (matchMode == 0) {
+            Date date;
+            if (!Date::parse(key.data(), key.data() + key.size(), date)) {
+                return results;
+            }
+            for (const auto& member : members) {
+                if ((member.*getter)() == date) {
+                    results.push_back(&member);
+                }
+            }
+        }
+        else {
+            std::string text;
+            for (const auto& member : members) {
+                text.clear();
+                (member.*getter)().appendTo(text);
+                if (text.find(key) != std::string::npos) {
+                    results.push_back(&member);
+                }
+            }
+        }
+        return results;
+}
+
 // 以姓名查找一位会员
+// 模糊匹配与影子列中预先规范化的姓名比较, 不区分大小写与全半角
 std::vector<const Member*> MemberManager::findByName(const std::string& name, int matchMode) const {
-    return findByField(members, name, &Member::getName , matchMode);
+    if (matchMode != 1) {
+        return findByField(members, name, &Member::getName , matchMode);
+    }
+
+    std::vector<const Member*> results;
+    std::string foldedKey = TextNormalizer::fold(name);
+    for (size_t i = 0; i < members.size(); i++) {
+        if (foldedNames[i].find(foldedKey) != std::string::npos) {
+            results.push_back(&members[i]);
+        }
+    }
+    return results;
 }
 
 // 以手机号码查找一位会员
@@ -160,12 +271,12 @@ std::vector<const Member*> MemberManager::findByPhoneNumber(const std::string& p
 
 // 以注册日期查找一位会员
 std::vector<const Member*> MemberManager::findByRegistrationDate(const std::string& registrationDate, int matchMode) const {
-    return findByField(members, registrationDate, &Member::getRegistrationDate, matchMode);
+    return findByDateField(members, registrationDate, &Member::getRegistrationDate, matchMode);
 }
 
 // 以过期日期查找一位会员
 std::vector<const Member*> MemberManager::findByExpiryDate(const std::string& expiryDate, int matchMode) const {
-    return findByField(members, expiryDate, &Member::getExpiryDate, matchMode);
+    return findByDateField(members, expiryDate, &Member::getExpiryDate, matchMode);
 }
 
 // 查找管理员
@@ -215,6 +326,10 @@ int MemberManager::getAdminCount() const {
     return count;
 }
 
+uint64_t MemberManager::getRosterRevision() const {
+    return rosterRevision;
+}
+
 // 重新加载文件
 void MemberManager::reload() {
     loadFromFile();
@@ -227,8 +342,42 @@ void MemberManager::clearCache() {
 
 // 检查 MemberID 是否存在
 bool MemberManager::isMemberIDExists(const std::string& memberID) const {
-    return std::find_if(members.begin(), members.end(),
-        [&](const Member& member) { return member.getMemberID() == memberID; }) != members.end();
+    return idIndex.find(memberID) != idIndex.end();
+}
+
+// 私有: 助手: 取分页用的排序下标
+const std::vector<size_t>* MemberManager::orderFor(int sortOrder) const {
+    if (sortOrder != 0 && sortOrder != 1) {
+        throw std::runtime_error("无效排序码");
+    }
+    if (sortOrder == 0) {
+        return nullptr;
+    }
+    if (!keyOrderValid) {
+        Pagination::sortByKey(members, &Member::getMemberID, keyOrder);
+        keyOrderValid = true;
+    }
+    return &keyOrder;
+}
+
+// 按偏移分页
+Page<Member> MemberManager::getMembersPage(size_t offset, size_t limit, int sortOrder) const {
+    return Pagination::makePage(members, orderFor(sortOrder), offset, limit, &Member::getMemberID);
+}
+
+// 按游标分页: 存储顺序时由主键索引定位游标, 主键顺序时二分查找
+Page<Member> MemberManager::getMembersPageAfter(const std::string& cursor, size_t limit, int sortOrder) const {
+    const std::vector<size_t>* order = orderFor(sortOrder);
+    size_t start = 0;
+    if (!cursor.empty()) {
+        if (order != nullptr) {
+            start = Pagination::positionAfter(members, *order, cursor, &Member::getMemberID);
+        } else {
+            auto it = idIndex.find(cursor);
+            start = it == idIndex.end() ? members.size() : it->second + 1;
+        }
+    }
+    return Pagination::makePage(members, order, start, limit, &Member::getMemberID);
 }
 
 // 批量操作 (RAII)
@@ -3,12 +3,20 @@
 
 #include "../models/Member.h"
 #include "../utils/FileHandler.h"
+#include "../utils/Pagination.h"
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 class MemberManager {
 private:
     std::vector<Member> members;
+    std::vector<std::string> rejectedLines;    // 加载时无法解析的原始行, 不参与查询, 保存时原样写回
+    std::unordered_map<std::string, size_t> idIndex;       // MemberID -> members 下标
+    mutable std::vector<size_t> keyOrder;                   // 按会员 ID排序的下标, 分页时按需生成
+    mutable bool keyOrderValid = false;
+    uint64_t rosterRevision = 0;    // 会员被删除、重载或偏好变更时递增; 只追加新会员时不变
+    std::vector<std::string> foldedNames;                   // 姓名的规范化形式 (影子列), 与 members 一一对应
     std::string filePath;
     FileHandler fileHandler;
 
@@ -19,14 +27,22 @@ private:
     // 助手: 将会员数据保存到文件
     void saveToFile();
 
+    // 助手: 依据 members 重建 MemberID 索引及姓名影子列
+    void rebuildIndex();
+
     // 用于批量操作
     bool autoSave = true;
+    int groupDepth = 0;         // 组提交嵌套层数, 大于 0 时只标记 groupDirty, 最外层结束时统一保存
+    bool groupDirty = false;
     void setAutoSave(bool enable = true);
     bool isAutoSaveEnabled() const;
 
     // 助手: 检查自动保存标志决定是否需要保存
     void saveIfNeeded();
 
+    // 助手: 取分页用的排序下标, 存储顺序时返回 nullptr
+    const std::vector<size_t>* orderFor(int sortOrder) const;
+
 public:
     // 构造函数
     explicit MemberManager(const std::string& filePath = "../data/members.csv");
@@ -51,10 +67,20 @@ public:
     const std::vector<Member> &getAllMembers() const;
     int getTotalMembers() const;
     int getAdminCount() const;
+    uint64_t getRosterRevision() const;     // 供推荐器判断已有会员行是否需要重建
+
+    // 分页 (sortOrder: 0 存储顺序, 1 按会员 ID升序), 只返回指针, 不复制会员
+    Page<Member> getMembersPage(size_t offset, size_t limit, int sortOrder = 0) const;
+    // 键集分页: 从游标 (上一页的 nextCursor) 之后开始, 游标为空时从头开始; 游标已失效时返回空页
+    Page<Member> getMembersPageAfter(const std::string& cursor, size_t limit, int sortOrder = 0) const;
 
     // 实用方法
     void reload();          // 重新加载文件
     void clearCache();      // 清除文件处理器缓存
+
+    // 组提交 (由 UnitOfWork 调用): 期间的变更合并为一次整表保存
+    void beginGroupCommit();
+    void endGroupCommit();
     bool isMemberIDExists(const std::string& memberID) const;
 
     // 批量操作 (RAII)
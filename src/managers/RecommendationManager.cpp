@@ -1,112 +1,342 @@
 // RecommendationManager.cpp 实现
 
 #include "RecommendationManager.h"
+#include "../config/Config.h"
+#include "../utils/SimilarityKernel.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <iostream>
+#include <stdexcept>
 
 // 构造函数
-RecommendationManager::RecommendationManager(
-    const std::string &bookPath,
-    const std::string &memberPath,
-    const std::string &transactionPath) :
-        bookManager(bookPath),
-        memberManager(memberPath),
-        transactionManager(transactionPath) {}
-
-// 类型 -> 索引 映射
-std::unordered_map<std::string, size_t> RecommendationManager::buildGenreIndex(const std::vector<Book>& books) const {
-    std::unordered_map<std::string, size_t> index;
-    size_t next = 0;
-    for (const auto& book : books) {
-        const std::string& genre = book.getGenre();
-        if (index.find(genre) == index.end()) {
-            index[genre] = next++;
-        }
-    }
-    return index;
-}
-
-// 建立会员 偏好/历史 向量
-std::vector<double> RecommendationManager::buildMemberVector(
-    const Member& member,
-    const std::vector<Transaction>& transactions,
-    std::unordered_map<std::string, Book>& bookByISBN,
-    std::unordered_map<std::string, size_t>& genreIndex) const {
-    std::vector<double> vec(genreIndex.size(), 0.0);
-
-    // 偏好为冷启动用户提供强的信号
-    // 对明确偏好的高权重
-    const std::vector<std::string> preferences = member.getPreference();
-    for (const auto& pref : preferences) {
-        auto it = genreIndex.find(pref);
-        if (it != genreIndex.end()) {
-            vec[it->second] += 2.0;
+RecommendationManager::RecommendationManager(BookManager& bm, MemberManager& mm, TransactionManager& tm) :
+        bookManager(bm),
+        memberManager(mm),
+        transactionManager(tm),
+        memberIndex(Config::RECOMMEND_LSH_TABLES, Config::RECOMMEND_LSH_BITS) {
+    setNeighborSearchMode(Config::RECOMMEND_NEIGHBOR_SEARCH_MODE);
+}
+
+// 公有: 设置邻居查找方式
+void RecommendationManager::setNeighborSearchMode(int mode) {
+    if (mode != 0 && mode != 1) {
+        throw std::runtime_error("无效的邻居查找方式");
+    }
+    neighborSearchMode = mode;
+}
+
+int RecommendationManager::getNeighborSearchMode() const {
+    return neighborSearchMode;
+}
+
+// 私有: 助手: 检查各管理器的版本号, 决定增量折算还是整体重建
+void RecommendationManager::syncMatrix() {
+    const std::vector<Member>& allMembers = memberManager.getAllMembers();
+    const std::vector<Transaction>& allTransactions = transactionManager.getAllTransactions();
+
+    if (!matrixBuilt ||
+        bookManager.getGenreRevision() != seenGenreRevision ||
+        memberManager.getRosterRevision() != seenRosterRevision ||
+        transactionManager.getHistoryRevision() != seenHistoryRevision ||
+        allMembers.size() < rowMembers.size() ||
+        allTransactions.size() < foldedTransactions) {
+        rebuildMatrix();
+        return;
+    }
+
+    // 新注册的会员追加为新行, 其已有的借阅一并折算
+    for (size_t i = rowMembers.size(); i < allMembers.size(); i++) {
+        appendMemberRow(allMembers[i]);
+    }
+
+    // 新交易只影响其会员所在的行
+    std::unordered_set<size_t> touchedRows;
+    for (size_t i = foldedTransactions; i < allTransactions.size(); i++) {
+        foldTransaction(allTransactions[i]);
+        auto rowIt = memberRows.find(allTransactions[i].getUserSymbol());
+        if (rowIt != memberRows.end()) {
+            touchedRows.insert(rowIt->second);
+        }
+    }
+    foldedTransactions = allTransactions.size();
+    for (size_t row : touchedRows) {
+        normalizeRow(row);
+    }
+}
+
+// 私有: 助手: 只追加了交易时增量计入共借矩阵, 已有交易变化时交给后台整体重建
+// 返回矩阵当前是否可用; 构建完成前返回 false, 调用方改用 KNN
+bool RecommendationManager::syncCoBorrow() {
+    const std::vector<Transaction>& allTransactions = transactionManager.getAllTransactions();
+
+    if (coBorrowBuild.valid()) {
+        if (coBorrowBuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+        try {
+            coBorrow = coBorrowBuild.get();
+            coBorrowBuilt = true;
+            coBorrowFolded = coBorrowBuildFolded;
+            coBorrowHistoryRevision = coBorrowBuildRevision;
+        } catch (std::exception& e) {
+            std::cerr << "共借矩阵构建失败: " << e.what() << std::endl;
+            coBorrowBuilt = false;      // 下次调用重新构建
+            return false;
+        }
+    }
+
+    if (!coBorrowBuilt ||
+        transactionManager.getHistoryRevision() != coBorrowHistoryRevision ||
+        allTransactions.size() < coBorrowFolded) {
+        coBorrowBuilt = false;
+        startCoBorrowBuild();
+        return false;
+    }
+    for (size_t i = coBorrowFolded; i < allTransactions.size(); i++) {
+        coBorrow.add(allTransactions[i].getUserSymbol(), allTransactions[i].getISBNSymbol());
+    }
+    coBorrowFolded = allTransactions.size();
+    return true;
+}
+
+// 私有: 助手: 复制全部 (会员, 图书) 对, 在后台线程中由副本构建共借矩阵; 线程不接触各管理器
+void RecommendationManager::startCoBorrowBuild() {
+    const std::vector<Transaction>& allTransactions = transactionManager.getAllTransactions();
+    std::vector<std::pair<Symbol, Symbol>> borrows;
+    borrows.reserve(allTransactions.size());
+    for (const auto& transaction : allTransactions) {
+        borrows.emplace_back(transaction.getUserSymbol(), transaction.getISBNSymbol());
+    }
+    coBorrowBuildFolded = allTransactions.size();
+    coBorrowBuildRevision = transactionManager.getHistoryRevision();
+    coBorrow = CoBorrowMatrix();        // 旧矩阵已过期, 先释放
+
+    coBorrowBuild = std::async(std::launch::async, [](const std::vector<std::pair<Symbol, Symbol>>& pairs) {
+        CoBorrowMatrix matrix;
+        for (const auto& borrow : pairs) {
+            matrix.add(borrow.first, borrow.second);
+        }
+        matrix.compact();
+        return matrix;
+    }, std::move(borrows));
+}
+
+// 私有: 助手: 由全部书目、会员和交易重建矩阵
+void RecommendationManager::rebuildMatrix() {
+    const std::vector<Book>& allBooks = bookManager.getAllBooks();
+    const std::vector<Member>& allMembers = memberManager.getAllMembers();
+    const std::vector<Transaction>& allTransactions = transactionManager.getAllTransactions();
+
+    genreColumns.clear();
+    genreIndex.clear();
+    genreOfISBN.clear();
+    genreOfISBN.reserve(allBooks.size());
+    for (const auto& book : allBooks) {
+        Symbol genre = book.getGenreSymbol();
+        auto inserted = genreIndex.emplace(genre, genreColumns.size());
+        if (inserted.second) {
+            genreColumns.push_back(genre);
+        }
+        genreOfISBN[book.getISBNSymbol()] = inserted.first->second;
+    }
+
+    size_t columns = genreColumns.size();
+    memberRows.clear();
+    rowMembers.clear();
+    weights.clear();
+    weights.reserve(allMembers.size() * columns);
+    for (const auto& member : allMembers) {
+        // 偏好为冷启动用户提供强的信号
+        // 对明确偏好的高权重
+        memberRows.emplace(member.getMemberSymbol(), rowMembers.size());
+        rowMembers.push_back(member.getMemberSymbol());
+        weights.resize(weights.size() + columns, 0.0);
+        double* row = weights.data() + weights.size() - columns;
+        for (Symbol pref : member.getPreferenceSymbols()) {
+            auto it = genreIndex.find(pref);
+            if (it != genreIndex.end()) {
+                row[it->second] += 2.0;
+            }
         }
     }
 
     // 借阅历史提供协作信号
-    // 对过去的借款增加权重
-    for (const auto& transaction : transactions) {
-        if (transaction.getUserID() != member.getMemberID()) {      // 跳过其他会员
-            continue;
+    isbnPopularity.clear();
+    for (const auto& transaction : allTransactions) {
+        foldTransaction(transaction);
+    }
+    foldedTransactions = allTransactions.size();
+
+    unitColumns.assign(columns, std::vector<float>(rowMembers.size(), 0.0f));
+    memberIndexBuilt = false;
+    for (size_t row = 0; row < rowMembers.size(); row++) {
+        normalizeRow(row);
+    }
+
+    matrixBuilt = true;
+    seenGenreRevision = bookManager.getGenreRevision();
+    seenRosterRevision = memberManager.getRosterRevision();
+    seenHistoryRevision = transactionManager.getHistoryRevision();
+}
+
+// 私有: 助手: 为新会员追加一行; 只折算已折算前缀中属于他的交易, 其余由 syncMatrix 随新交易折算
+void RecommendationManager::appendMemberRow(const Member& member) {
+    size_t columns = genreColumns.size();
+    size_t row = rowMembers.size();
+    memberRows.emplace(member.getMemberSymbol(), row);
+    rowMembers.push_back(member.getMemberSymbol());
+    weights.resize(weights.size() + columns, 0.0);
+    for (auto& column : unitColumns) {
+        column.push_back(0.0f);
+    }
+
+    for (Symbol pref : member.getPreferenceSymbols()) {
+        auto it = genreIndex.find(pref);
+        if (it != genreIndex.end()) {
+            weights[row * columns + it->second] += 2.0;
         }
-        auto bookIt = bookByISBN.find(transaction.getISBN());
-        if (bookIt == bookByISBN.end()) {
-            continue;
+    }
+
+    const Transaction* first = transactionManager.getAllTransactions().data();
+    for (const Transaction* transaction : transactionManager.findByMemberID(member.getMemberID())) {
+        if (static_cast<size_t>(transaction - first) >= foldedTransactions) {
+            break;
         }
-        const std::string& genre = bookIt->second.getGenre();
-        auto indexIt = genreIndex.find(genre);
-        if (indexIt != genreIndex.end()) {
-            vec[indexIt->second] += 1.0;
+        auto genreIt = genreOfISBN.find(transaction->getISBNSymbol());
+        if (genreIt != genreOfISBN.end()) {
+            weights[row * columns + genreIt->second] += 1.0;
         }
     }
-    return vec;
+    normalizeRow(row);
 }
 
-// 用于 KNN 的余弦相似度
-double RecommendationManager::cosineSimilarity(
-    const std::vector<double> &lhs,
-    const std::vector<double> &rhs) {
-    if (lhs.empty() || rhs.empty() || lhs.size() != rhs.size()) {
-        return 0.0;
+// 私有: 助手: 对过去的借款增加权重
+void RecommendationManager::foldTransaction(const Transaction& transaction) {
+    isbnPopularity[transaction.getISBNSymbol()]++;
+
+    auto rowIt = memberRows.find(transaction.getUserSymbol());
+    if (rowIt == memberRows.end()) {
+        return;
+    }
+    auto genreIt = genreOfISBN.find(transaction.getISBNSymbol());
+    if (genreIt == genreOfISBN.end()) {
+        return;
     }
+    weights[rowIt->second * genreColumns.size() + genreIt->second] += 1.0;
+}
+
+void RecommendationManager::normalizeRow(size_t row) {
+    size_t columns = genreColumns.size();
+    const double* source = weights.data() + row * columns;
 
-    double dot = 0.0;       // 点积
-    double normLhs = 0.0;   // 左操作数的范数
-    double normRhs = 0.0;   // 右操作数的范数
-    for (size_t i = 0; i < lhs.size(); ++i) {
-        dot += lhs[i] * rhs[i];
-        normLhs += lhs[i] * lhs[i];
-        normRhs += rhs[i] * rhs[i];
+    double norm = 0.0;
+    for (size_t i = 0; i < columns; i++) {
+        norm += source[i] * source[i];
     }
-    if (normLhs <= 0 || normRhs <= 0) {
-        return 0.0;
+    norm = std::sqrt(norm);
+    for (size_t i = 0; i < columns; i++) {
+        unitColumns[i][row] = norm > 0 ? static_cast<float>(source[i] / norm) : 0.0f;
     }
 
-    return dot / (std::sqrt(normLhs) * std::sqrt(normRhs));
+    if (memberIndexBuilt) {
+        std::vector<float> unit(columns);
+        unitRow(row, unit.data());
+        memberIndex.update(static_cast<uint32_t>(row), unit.data());
+    }
 }
 
-// 收集已阅图书的 ISBN
-std::unordered_set<std::string> RecommendationManager::getMemberBorrowedISBNs(
-    const std::string& memberID,
-    const std::vector<Transaction>& transactions) const {
-    std::unordered_set<std::string> borrowed;
-    for (const auto& transaction : transactions) {
-        if (transaction.getUserID() == memberID) {
-            borrowed.insert(transaction.getISBN());
-        }
+void RecommendationManager::unitRow(size_t row, float* out) const {
+    for (size_t i = 0; i < genreColumns.size(); i++) {
+        out[i] = unitColumns[i][row];
+    }
+}
+
+// 私有: 助手: 由全部单位行建立 LSH 索引
+void RecommendationManager::buildMemberIndex() {
+    std::vector<float> unit(genreColumns.size());
+    memberIndex.reset(genreColumns.size());
+    for (size_t row = 0; row < rowMembers.size(); row++) {
+        unitRow(row, unit.data());
+        memberIndex.update(static_cast<uint32_t>(row), unit.data());
+    }
+    memberIndexBuilt = true;
+}
+
+// 用于 KNN 的余弦相似度: 目标行作为查询向量, 一次计算所有行
+void RecommendationManager::cosineSimilarities(size_t targetRow, std::vector<float>& similarities) const {
+    size_t columns = genreColumns.size();
+    std::vector<const float*> columnData(columns);
+    std::vector<float> target(columns);
+    for (size_t i = 0; i < columns; i++) {
+        columnData[i] = unitColumns[i].data();
+        target[i] = unitColumns[i][targetRow];
+    }
+
+    similarities.resize(rowMembers.size());
+    SimilarityKernel::weightedColumnSum(columnData.data(), target.data(), columns,
+                                        rowMembers.size(), similarities.data());
+}
+
+// 前 k 个邻居: 以 "最差者在堆顶" 的小顶堆保留 k 个, 总代价 O(n log k), 不对全部会员排序
+// better(a, b): a 排在 b 之前
+static bool betterNeighbor(const std::pair<size_t, float>& a, const std::pair<size_t, float>& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+void RecommendationManager::offerNeighbor(std::vector<std::pair<size_t, float>>& heap, size_t k,
+                                          size_t row, float similarity) {
+    if (!(similarity > 0.0f)) {
+        return;
+    }
+    std::pair<size_t, float> entry(row, similarity);
+    if (heap.size() < k) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), betterNeighbor);
+    } else if (betterNeighbor(entry, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), betterNeighbor);
+        heap.back() = entry;
+        std::push_heap(heap.begin(), heap.end(), betterNeighbor);
     }
-    return borrowed;
 }
 
-// 计算 ISBN 受欢迎程度
-std::unordered_map<std::string, int> RecommendationManager::buildISBNPopularity(
-    const std::vector<Transaction>& transactions) const {
-    std::unordered_map<std::string, int> countByISBN;
-    for (const auto& transaction : transactions) {
-        countByISBN[transaction.getISBN()]++;
+std::vector<std::pair<size_t, float>> RecommendationManager::findNeighbors(size_t targetRow, int kNeighbors) {
+    std::vector<std::pair<size_t, float>> heap;
+    size_t k = kNeighbors > 0 ? static_cast<size_t>(kNeighbors) : rowMembers.size();
+    heap.reserve(std::min(k, rowMembers.size()));
+
+    if (neighborSearchMode == 1) {
+        if (!memberIndexBuilt) {
+            buildMemberIndex();
+        }
+        // 候选行的相似度按与 SimilarityKernel 相同的顺序逐维累加, 与精确模式的结果逐位一致
+        size_t columns = genreColumns.size();
+        std::vector<float> target(columns);
+        unitRow(targetRow, target.data());
+        std::vector<uint32_t> candidateRows;
+        memberIndex.candidates(target.data(), candidateRows);
+        for (uint32_t row : candidateRows) {
+            if (row == targetRow) {
+                continue;
+            }
+            float similarity = 0.0f;
+            for (size_t i = 0; i < columns; i++) {
+                similarity += target[i] * unitColumns[i][row];
+            }
+            offerNeighbor(heap, k, row, similarity);
+        }
+    } else {
+        std::vector<float> similarities;
+        cosineSimilarities(targetRow, similarities);
+        for (size_t row = 0; row < similarities.size(); row++) {
+            if (row != targetRow) {
+                offerNeighbor(heap, k, row, similarities[row]);
+            }
+        }
     }
-    return countByISBN;
+
+    std::sort_heap(heap.begin(), heap.end(), betterNeighbor);
+    return heap;
 }
 
 // 主推荐函数
@@ -125,125 +355,108 @@ std::vector<Book> RecommendationManager::recommendForMember(
         return {};
     }
 
-    // 加载所有书籍、交易和会员
-    const std::vector<Book> allBooks = bookManager.getAllBooks();
-    const std::vector<Transaction>& allTransactions = transactionManager.getAllTransactions();
-    const std::vector<Member>& allMembers = memberManager.getAllMembers();
-
-    std::unordered_map<std::string, Book> bookByISBN;       // ISBN -> 书籍 映射
-    bookByISBN.reserve(allBooks.size());
-    for (const auto& book : allBooks) {
-        bookByISBN[book.getISBN()] = book;
-    }
-
-    std::unordered_map<std::string, size_t> genreIndex = buildGenreIndex(allBooks);
-    if (genreIndex.empty()) {
+    syncMatrix();
+    if (genreColumns.empty()) {
         return {};
     }
 
-    const std::vector<double> targetVec = buildMemberVector(
-        *targetMember, allTransactions, bookByISBN, genreIndex);
+    const std::vector<Book>& allBooks = bookManager.getAllBooks();
+    const SymbolTable& symbols = SymbolTable::getInstance();
+    size_t columns = genreColumns.size();
+    Symbol targetID = targetMember->getMemberSymbol();
+    size_t targetRow = memberRows.at(targetID);
+    const double* targetVec = weights.data() + targetRow * columns;     // 原始权重, 用于回退评分
 
-    // 邻居 ID 及与其相似度
-    std::vector<std::pair<std::string, double> > neighborScore;
-    neighborScore.reserve(allMembers.size());
-    for (const auto& member : allMembers) {
-        if (member.getMemberID() == targetMember->getMemberID()) {
-            continue;
-        }
-
-        const std::vector<double> vec = buildMemberVector(
-            member, allTransactions, bookByISBN, genreIndex);
-        double similarity = cosineSimilarity(vec, targetVec);
-        if (similarity > 0.0) {
-            neighborScore.emplace_back(member.getMemberID(), similarity);
-        }
+    // 会员的借阅经交易管理器的会员索引取得, 不再扫描全部交易
+    std::unordered_set<Symbol> borrowedByTarget;
+    for (const Transaction* transaction : transactionManager.findByMemberID(memberID)) {
+        borrowedByTarget.insert(transaction->getISBNSymbol());
     }
 
-    // 按照相似度排序
-    std::sort(neighborScore.begin(), neighborScore.end(),
-    [](const std::pair<std::string, double>& lhs, const std::pair<std::string, double>& rhs)
-    {return lhs.second > rhs.second;});
+    std::unordered_map<Symbol, double> candidateScores;
 
-    if (kNeighbors > 0 && static_cast<size_t>(kNeighbors) < neighborScore.size()) {
-        neighborScore.resize(static_cast<size_t>(kNeighbors));      // 保留前 k 个邻居
+    // 基于物品: 只查目标会员借过的书在共借矩阵中的行; 矩阵仍在后台构建时跳过, 由下面的 KNN 给出结果
+    if (syncCoBorrow() && coBorrow.score(targetID, candidateScores) > 0) {
+        for (Symbol isbn : borrowedByTarget) {         // 已移出共借窗口的早期借阅同样不推荐
+            candidateScores.erase(isbn);
+        }
     }
 
-    const std::unordered_set<std::string> borrowedByTarget = getMemberBorrowedISBNs(memberID, allTransactions);
-    const std::unordered_map<std::string, int> bookPopularity = buildISBNPopularity(allTransactions);
+    if (candidateScores.empty()) {
+        // 邻居行号及与其相似度
+        std::vector<std::pair<size_t, float>> neighborScore = findNeighbors(targetRow, kNeighbors);
 
-    std::unordered_map<std::string, double> candidateScores;
-
-    for (const auto& neighbor : neighborScore) {
-        const std::string& neighborID = neighbor.first;
-        double neighborSimilarity = neighbor.second;
-        for (const auto& transaction : allTransactions) {
-            if (transaction.getUserID() != neighborID) {
-                continue;
-            }
-            const std::string& neighborISBN = transaction.getISBN();
-            if (borrowedByTarget.find(neighborISBN) != borrowedByTarget.end()) {
-                continue;
+        for (const auto& neighbor : neighborScore) {
+            double neighborSimilarity = neighbor.second;
+            Symbol neighborID = rowMembers[neighbor.first];
+            for (const Transaction* transaction : transactionManager.findByMemberID(symbols.text(neighborID))) {
+                Symbol neighborISBN = transaction->getISBNSymbol();
+                if (borrowedByTarget.find(neighborISBN) != borrowedByTarget.end()) {
+                    continue;
+                }
+                candidateScores[neighborISBN] += neighborSimilarity;
             }
-            candidateScores[transaction.getISBN()] += neighborSimilarity;
         }
     }
 
     // 回退：如果没有邻居, 则使用目标向量进行基于内容的评分
     if (candidateScores.empty()) {      // 没有候选人
         for (const auto& book : allBooks) {
-            const std::string& isbn = book.getISBN();
+            Symbol isbn = book.getISBNSymbol();
             if (borrowedByTarget.find(isbn) != borrowedByTarget.end()) {
                 continue;
             }
-            auto idxIt = genreIndex.find(book.getGenre());
+            auto idxIt = genreIndex.find(book.getGenreSymbol());
             if (idxIt == genreIndex.end()) {
                 continue;
             }
 
             double base = targetVec[idxIt->second];     // 基于偏好的基础分
             int pop = 0;                                // 受欢迎程度统计
-            auto popIt = bookPopularity.find(isbn);
-            if (popIt != bookPopularity.end()) {
+            auto popIt = isbnPopularity.find(isbn);
+            if (popIt != isbnPopularity.end()) {
                 pop = popIt->second;
             }
             candidateScores[isbn] = base + (0.1 * static_cast<double>(pop));
         }
     } else {                                            // 有候选人
         for (auto& entry: candidateScores) {
-            auto popIt = bookPopularity.find(entry.first);
-            if (popIt != bookPopularity.end()) {
+            auto popIt = isbnPopularity.find(entry.first);
+            if (popIt != isbnPopularity.end()) {
                 entry.second += 0.05 * static_cast<double>(popIt->second);
             }
         }
     }
 
-    std::vector<std::pair<std::string, double> > scoredISBNs;       // 已评分的 ISBN 向量
+    std::vector<std::pair<Symbol, double> > scoredISBNs;            // 已评分的 ISBN 向量
     scoredISBNs.reserve(candidateScores.size());
     for (const auto& entry: candidateScores) {
         scoredISBNs.emplace_back(entry);
     }
 
-    std::sort(scoredISBNs.begin(), scoredISBNs.end(),               // 按分数排序候选人
-        [](const std::pair<std::string, double>& lhs, const std::pair<std::string, double>& rhs) {
+    // 按分数排序候选人, 同分按 ISBN 字符串; 候选可能有上万本而只取前 topN 本可借的,
+    // 因此建堆后逐个弹出, 不对全部候选排序
+    auto ranksAfter = [&symbols](const std::pair<Symbol, double>& lhs, const std::pair<Symbol, double>& rhs) {
         if (lhs.second != rhs.second) {
-            return lhs.second > rhs.second;
+            return lhs.second < rhs.second;
         }
-            return lhs.first < rhs.first; });       // 按 ISBN 排序
+        return symbols.text(lhs.first) > symbols.text(rhs.first);
+    };
+    std::make_heap(scoredISBNs.begin(), scoredISBNs.end(), ranksAfter);
 
     std::vector<Book> resultBooks;
-    for (const auto& score : scoredISBNs) {
-        if (static_cast<int>(resultBooks.size()) >= topN) {
-            break;
-        }
-        auto bookIt = bookByISBN.find(score.first);
-        if (bookIt == bookByISBN.end()) {
+    while (!scoredISBNs.empty() && static_cast<int>(resultBooks.size()) < topN) {
+        std::pop_heap(scoredISBNs.begin(), scoredISBNs.end(), ranksAfter);
+        std::pair<Symbol, double> score = scoredISBNs.back();
+        scoredISBNs.pop_back();
+        const Book* book = bookManager.findBookByISBN(symbols.text(score.first));
+        if (book == nullptr) {
             continue;
         }
-        if (availableOnly && !bookIt->second.canBorrow()) {
+        if (availableOnly && !book->canBorrow()) {
             continue;
         }
-        resultBooks.emplace_back(bookIt->second);
+        resultBooks.emplace_back(*book);
     }
     return resultBooks;
 }
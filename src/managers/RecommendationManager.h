@@ -4,43 +4,94 @@
 #include "BookManager.h"
 #include "MemberManager.h"
 #include "TransactionManager.h"
+#include "../utils/CoBorrowMatrix.h"
+#include "../utils/CosineLSH.h"
+#include <cstdint>
+#include <future>
 #include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
 class RecommendationManager {
 private:
-    BookManager bookManager;
-    MemberManager memberManager;
-    TransactionManager transactionManager;
+    // 与菜单共享的数据管理器, 不另行加载副本
+    BookManager& bookManager;
+    MemberManager& memberManager;
+    TransactionManager& transactionManager;
 
-    std::unordered_map<std::string, size_t> buildGenreIndex(const std::vector<Book>& books) const;
-    std::vector<double> buildMemberVector(
-        const Member& member,
-        const std::vector<Transaction>& transactions,
-        std::unordered_map<std::string, Book>& bookByISBN,
-        std::unordered_map<std::string, size_t>& genreIndex) const;
+    // 会员 x 类别 偏好矩阵, 行与 getAllMembers() 一一对应
+    // weights 为原始权重 (偏好类别 +2, 每次借阅该类别 +1), 按行优先连续存放
+    // unitColumns 为归一化到单位长度的同一矩阵 (零行保持为零), 按列存放的 float, 供 SimilarityKernel 一次处理多行
+    // 推荐时同步: 只追加了交易或会员时增量折算; 书目类型、已有会员或已有交易发生变化时整体重建
+    // 图书、会员和类别均以驻留句柄为键, 打分过程中不比较也不复制字符串
+    std::vector<Symbol> genreColumns;                       // 列 -> 类别, 按书目中首次出现的顺序
+    std::unordered_map<Symbol, size_t> genreIndex;          // 类别 -> 列
+    std::unordered_map<Symbol, size_t> genreOfISBN;         // ISBN -> 列
+    std::unordered_map<Symbol, size_t> memberRows;          // 会员 ID -> 行
+    std::vector<Symbol> rowMembers;                         // 行 -> 会员 ID
+    std::vector<double> weights;
+    std::vector<std::vector<float>> unitColumns;             // 列 -> 各行在该类别上的单位向量分量
+    std::unordered_map<Symbol, int> isbnPopularity;         // ISBN -> 借阅次数
+    size_t foldedTransactions = 0;                          // 已折算进矩阵的交易数 (getAllTransactions 的前缀)
+    bool matrixBuilt = false;
+    uint64_t seenGenreRevision = 0;
+    uint64_t seenRosterRevision = 0;
+    uint64_t seenHistoryRevision = 0;
 
-    // KNN
-    static double cosineSimilarity(const std::vector<double>& lhs, const std::vector<double>& rhs);
+    // 图书共借矩阵, 只依赖交易; 与上面的矩阵分别同步, 书目或会员变化时不必重建
+    // 整体构建在后台线程中进行, 完成前推荐走 KNN 路径, 交互请求不等待构建; 之后只追加了交易时在前台增量计入
+    // 析构时等待进行中的构建结束
+    CoBorrowMatrix coBorrow;
+    size_t coBorrowFolded = 0;                              // 已计入共借矩阵的交易数
+    bool coBorrowBuilt = false;
+    uint64_t coBorrowHistoryRevision = 0;
+    std::future<CoBorrowMatrix> coBorrowBuild;              // 进行中的后台构建
+    size_t coBorrowBuildFolded = 0;                         // 后台构建所含的交易数
+    uint64_t coBorrowBuildRevision = 0;
 
-    std::unordered_set<std::string> getMemberBorrowedISBNs(const std::string& memberID, const std::vector<Transaction>& transactions) const;
+    // 近似邻居查找: 单位行的 LSH 索引, 只在近似模式下建立, 之后随 normalizeRow 逐行更新; 矩阵重建时作废
+    int neighborSearchMode = 0;
+    CosineLSH memberIndex;
+    bool memberIndexBuilt = false;
 
-    std::unordered_map<std::string, int> buildISBNPopularity(const std::vector<Transaction>& transactions) const;
+    // 助手: 使矩阵与三个管理器的当前数据一致
+    void syncMatrix();
+    bool syncCoBorrow();                                    // 返回共借矩阵是否可用
+    void startCoBorrowBuild();
+    void rebuildMatrix();
+    void appendMemberRow(const Member& member);
+    void foldTransaction(const Transaction& transaction);  // 计入借阅次数与所在行的类别权重, 不重新归一化
+    void normalizeRow(size_t row);
+    void unitRow(size_t row, float* out) const;             // 取单位行 (长度为类别数)
+    void buildMemberIndex();
+
+    // KNN: 目标行与所有行的余弦相似度 (行已归一化, 即点积), 结果按行写入 similarities
+    void cosineSimilarities(size_t targetRow, std::vector<float>& similarities) const;
+    // 选出与目标行相似度为正的前 k 行 (k <= 0 时全部), 按相似度降序, 相同时按行号升序
+    // 精确模式比较所有行, 近似模式只比较 LSH 候选行
+    std::vector<std::pair<size_t, float>> findNeighbors(size_t targetRow, int kNeighbors);
+    // 助手: 把一行放进保留前 k 个的堆 (最差者在堆顶)
+    static void offerNeighbor(std::vector<std::pair<size_t, float>>& heap, size_t k, size_t row, float similarity);
 
 public:
-    explicit RecommendationManager(
-        const std::string& bookPath = "../data/books.csv",
-        const std::string& memberPath = "../data/members.csv",
-        const std::string& transactionPath = "../data/transactions.csv");
+    RecommendationManager(BookManager& bm, MemberManager& mm, TransactionManager& tm);
 
-    // 基于KNN的推荐(协同过滤), 配有内容/热门度回退机制
+    // 协同过滤推荐: 有借阅记录的会员按共借矩阵 (基于物品) 打分;
+    // 没有借阅记录或共借无结果时, 取偏好最相近的 kNeighbors 个会员 (KNN) 借过的书; 再无结果时按内容/热门度回退
     std::vector<Book> recommendForMember(
         const std::string& memberID,
         int topN = 5,
         int kNeighbors = 5,
         bool availableOnly = true);
+
+    // 邻居查找方式, 初始值取自 Config::RECOMMEND_NEIGHBOR_SEARCH_MODE
+    // 只影响冷启动的 KNN 路径 (没有借阅记录或共借无结果的会员); 有借阅记录的会员按共借矩阵打分, 不受影响
+    // mode = 0 --> 精确查找, 与所有会员比较
+    // mode = 1 --> 近似查找, 经 LSH 索引只与候选会员比较; 会员很多时更快, 可能漏掉部分最近邻
+    void setNeighborSearchMode(int mode);
+    int getNeighborSearchMode() const;
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_RECOMMENDATIONMANAGER_H
@@ -10,18 +10,13 @@
 #include <utility>
 
 // 构造函数
-ReportManager::ReportManager(const std::string& bookPath,
-                             const std::string& memberPath,
-                             const std::string& transactionPath,
-                             const std::string& reservationPath,
+ReportManager::ReportManager(BookManager& bm, MemberManager& mm, TransactionManager& tm, ReservationManager& rsm,
                              const std::string& reportsDirectory)
-    : bookManager(bookPath),
-      memberManager(memberPath),
-      transactionManager(transactionPath),
-      reservationManager(reservationPath),
-      reportsDir(reportsDirectory) {
-    reloadAll();
-}
+    : bookManager(bm),
+      memberManager(mm),
+      transactionManager(tm),
+      reservationManager(rsm),
+      reportsDir(reportsDirectory) {}
 
 // 重新加载所有数据
 void ReportManager::reloadAll() {
@@ -48,16 +43,14 @@ std::string ReportManager::joinPath(const std::string& dir, const std::string& f
 // 构造报告文件名
 std::string ReportManager::buildReportFileName(const std::string& prefix) const {
     // 以时间戳生成文件名: prefix_YYYYMMDD_HHMMSS.txt
-    time_t currentTime = DateUtils::getCurrentTimestamp();
-    std::string currentDate = DateUtils::getCurrentDate();
-    tm * timeInfo = localtime(&currentTime);
+    DateUtils::LocalDateTime now = DateUtils::toLocalDateTime(DateUtils::getCurrentTimestamp());
 
     std::ostringstream oss;
     oss << prefix << "_"
-        << std::setfill('0') << currentDate << "_"
-        << std::setw(2) << timeInfo->tm_hour
-        << std::setw(2) << timeInfo->tm_min
-        << std::setw(2) << timeInfo->tm_sec
+        << std::setfill('0') << now.date << "_"
+        << std::setw(2) << now.hour
+        << std::setw(2) << now.minute
+        << std::setw(2) << now.second
         << ".txt";
 
     return oss.str();
@@ -141,7 +134,7 @@ std::vector<std::string> ReportManager::buildInventoryReport() const{
     lines.emplace_back("--------------|--------------------------|-----------------|-------|----------|");
 
     // 书籍详细信息
-    auto allBooks = bookManager.getAllBooks();
+    const auto& allBooks = bookManager.getAllBooks();
     for (const auto& book : allBooks) {
         std::string truncatedTitle = book.getTitle();
         if (truncatedTitle.length() > 24) {
@@ -187,7 +180,7 @@ std::vector<std::string> ReportManager::buildMemberReport() const {
     lines.emplace_back("----------|----------------------|--------------|-------------------|-----------");
 
     // 会员信息
-    auto allMembers = memberManager.getAllMembers();
+    const auto& allMembers = memberManager.getAllMembers();
     for (const auto& member : allMembers) {
         std::ostringstream oss;
         oss << std::left
@@ -231,51 +224,35 @@ std::vector<std::string> ReportManager::buildTransactionReport(int topN) const {
     lines.emplace_back("---------------|-----------|---------------|-------------|------------|----------|-----");
 
     // 交易信息
-    auto allTransactions = transactionManager.getAllTransactions();
-
-    // 按借阅日期（降序）部分排序以获取最近的交易
-    std::vector<const Transaction*> transactionPtrs;
-    transactionPtrs.reserve(allTransactions.size());
-    for (const auto& trans : allTransactions) {
-        transactionPtrs.emplace_back(&trans);
-    }
-
-    if (topN < transactionPtrs.size()){
-        std::partial_sort(transactionPtrs.begin(),
-                          transactionPtrs.begin() + topN,
-                          transactionPtrs.end(),
-                          [](const Transaction* a, const Transaction* b){
-                            return a->getBorrowDate() > b->getBorrowDate();
-                          });
-        transactionPtrs.resize(topN);
-    } else {
-        std::sort(transactionPtrs.begin(), transactionPtrs.end(),
-                  [](const Transaction* a, const Transaction* b) {
-        return a->getBorrowDate() > b->getBorrowDate();
-    });
-    }
-
+    // 借出日索引已有序, 从最晚一端取前 topN 条即为最近的交易, 无需排序全部交易
     int count = 0;
-    for (const auto* trans : transactionPtrs) {
-        if (count >= topN) break;
-
+    transactionManager.forEachByDate(0, Date(), Date(), true, [&](const Transaction& trans) {
         std::ostringstream oss;
         oss << std::left
-            << std::setw(15) << trans->getTransactionID() << "| "
-            << std::setw(10) << trans->getUserID() << "| "
-            << std::setw(14) << trans->getISBN() << "| "
-            << std::setw(12) << trans->getBorrowDate() << "| "
-            << std::setw(11) << trans->getDueDate() << "| "
-            << std::setw(9) << (trans->haveReturned() ? "Yes" : "No") << "| "
-            << std::fixed << std::setprecision(2) << trans->getFine();
+            << std::setw(15) << trans.getTransactionID() << "| "
+            << std::setw(10) << trans.getUserID() << "| "
+            << std::setw(14) << trans.getISBN() << "| "
+            << std::setw(12) << trans.getBorrowDate() << "| "
+            << std::setw(11) << trans.getDueDate() << "| "
+            << std::setw(9) << (trans.haveReturned() ? "Yes" : "No") << "| "
+            << std::fixed << std::setprecision(2) << trans.getFine();
         lines.emplace_back(oss.str());
-        count++;
-    }
+        return ++count < topN;
+    });
 
     lines.emplace_back("");
     lines.emplace_back("总交易数: " + std::to_string(transactionManager.getTotalTransactions()));
     lines.emplace_back("活动交易数: " + std::to_string(transactionManager.getActiveTransactionsCount()));
     lines.emplace_back("逾期交易数: " + std::to_string(transactionManager.getOverdueTransactionsCount()));
+
+    // 近期借还: 在日期索引上二分得到区间大小, 不遍历交易
+    Date today = DateUtils::today();
+    Date since = today.addDays(1 - Config::REPORT_RECENT_DAYS);
+    std::string recentDays = std::to_string(Config::REPORT_RECENT_DAYS);
+    lines.emplace_back("近 " + recentDays + " 天借出数: " +
+                       std::to_string(transactionManager.countByDateRange(0, since, today)));
+    lines.emplace_back("近 " + recentDays + " 天归还数: " +
+                       std::to_string(transactionManager.countByDateRange(2, since, today)));
     lines.emplace_back("");
     lines.emplace_back("================================================");
 
@@ -302,7 +279,7 @@ std::vector<std::string> ReportManager::buildReservationReport() const {
     lines.emplace_back("---------------|-----------|--------------|------------------|--------");
 
     // 预约信息
-    auto allReservations = reservationManager.getAllReservations();
+    const auto& allReservations = reservationManager.getAllReservations();
     for (const auto& res : allReservations) {
         std::ostringstream oss;
         oss << std::left
@@ -341,18 +318,18 @@ std::vector<std::string> ReportManager::buildTopBorrowedBooksReport(int topN) co
     lines.emplace_back("Report Generated: " + currentDate);
     lines.emplace_back("");
 
-    // 按 ISBN 统计借阅频率
-    std::unordered_map<std::string, int> borrowCount;
-    auto allTransactions = transactionManager.getAllTransactions();
+    // 按 ISBN 统计借阅频率, 以驻留句柄计数, 只在输出时取回字符串
+    std::unordered_map<Symbol, int> borrowCount;
+    const auto& allTransactions = transactionManager.getAllTransactions();
 
     for (const auto& transaction : allTransactions) {
-        borrowCount[transaction.getISBN()]++;
+        borrowCount[transaction.getISBNSymbol()]++;
     }
 
     // 转换为向量并排序
-    std::vector<std::pair<std::string, int> > sortedBorrows(borrowCount.begin(), borrowCount.end());
+    std::vector<std::pair<Symbol, int> > sortedBorrows(borrowCount.begin(), borrowCount.end());
     std::sort(sortedBorrows.begin(), sortedBorrows.end(),
-        [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+        [](const std::pair<Symbol, int>& a, const std::pair<Symbol, int>& b) {
             return a.second > b.second;
         });
 
@@ -364,7 +341,7 @@ std::vector<std::string> ReportManager::buildTopBorrowedBooksReport(int topN) co
     for (const auto& pair : sortedBorrows) {
         if (rank > topN) break;
 
-        auto book = const_cast<BookManager&>(bookManager).findBookByISBN(pair.first);
+        auto book = const_cast<BookManager&>(bookManager).findBookByISBN(SymbolTable::getInstance().text(pair.first));
         if (book) {
             // 检查书目标题是否被截断
             std::string truncatedTitle = book->getTitle();
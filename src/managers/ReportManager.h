@@ -10,10 +10,11 @@
 
 class ReportManager {
 private:
-    BookManager bookManager;
-    MemberManager memberManager;
-    TransactionManager transactionManager;
-    ReservationManager reservationManager;
+    // 与菜单共享的数据管理器, 不另行加载副本
+    BookManager& bookManager;
+    MemberManager& memberManager;
+    TransactionManager& transactionManager;
+    ReservationManager& reservationManager;
     std::string reportsDir;                 // 报告输出目录
 
     // 拼接路径
@@ -32,24 +33,21 @@ private:
     std::vector<std::string> buildTopBorrowedBooksReport(int topN) const;
 
 public:
-    explicit ReportManager(
-        const std::string& bookPath = "../data/books.csv",
-        const std::string& memberPath = "../data/members.csv",
-        const std::string& transactionPath = "../data/transactions.csv",
-        const std::string& reservationPath = "../data/reservations.csv",
-        const std::string& reportsDirectory = "../reports");
-
-    // 重新加载所有数据
+    ReportManager(BookManager& bm, MemberManager& mm, TransactionManager& tm, ReservationManager& rsm,
+                  const std::string& reportsDirectory = "../reports");
+
+    // 从磁盘重新加载所有数据 (会使指向管理器内对象的指针失效)
     void reloadAll();
 
     // 生成器
-    bool generateSummaryReport(bool reload = true);
-    bool generateInventoryReport(bool reload = true);
-    bool generateMemberReport(bool reload = true);
-    bool generateTransactionReport(int topN = 10, bool reload = true);
-    bool generateReservationReport(bool reload = true);
-    bool generateTopBorrowedBooksReport(int topN = 10, bool reload = true);
-    bool generateAllReports(int topN = 10, bool reload = true);
+    // 共享的管理器即为最新数据, 默认无需重新加载
+    bool generateSummaryReport(bool reload = false);
+    bool generateInventoryReport(bool reload = false);
+    bool generateMemberReport(bool reload = false);
+    bool generateTransactionReport(int topN = 10, bool reload = false);
+    bool generateReservationReport(bool reload = false);
+    bool generateTopBorrowedBooksReport(int topN = 10, bool reload = false);
+    bool generateAllReports(int topN = 10, bool reload = false);
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_REPORTMANAGER_H
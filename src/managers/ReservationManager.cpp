@@ -3,17 +3,21 @@
 #include "ReservationManager.h"
 #include "MemberManager.h"
 #include "BookManager.h"
+#include "UnitOfWork.h"
 #include "../utils/DateUtils.h"
 #include "../utils/Validator.h"
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 
 // 构造函数
 ReservationManager::ReservationManager(const std::string& filePath)
     : filePath(filePath), fileHandler() {
+    // 数据已解析为对象常驻内存, 不再另存一份原始行
+    fileHandler.setCacheEnabled(filePath, false);
 
     if (!fileHandler.isFileExist(filePath)) {
         fileHandler.createFileIfNotExist(filePath);
@@ -29,20 +33,45 @@ ReservationManager::ReservationManager(const std::string& filePath)
 // 私有: 助手: 从文件加载预订数据
 void ReservationManager::loadFromFile() {
     reservations.clear();
+    rejectedLines.clear();
 
     try {
-        auto lines = fileHandler.readCSV(filePath);
-
-        // 跳过表头 (第一行)
-        for (size_t i = 1; i < lines.size(); i++) {
-            if (!lines[i].empty()) {
-                reservations.push_back(Reservation::fromCSV(lines[i]));
+        // 逐行流式解析, 字段直接从读缓冲区构造对象
+        bool isHeader = true;
+        size_t lineNumber = 0;
+        fileHandler.forEachLine(filePath, [&](const char* begin, const char* end) {
+            lineNumber++;
+            // 跳过表头 (第一行)
+            if (isHeader) {
+                isHeader = false;
+                return;
             }
-        }
+            if (begin == end) {
+                return;
+            }
+            // 无法解析的行 (如日期格式错误) 不载入, 保留原文, 避免保存时被改写或丢失
+            try {
+                reservations.push_back(Reservation::fromCSV(begin, end));
+            } catch (std::exception& e) {
+                std::cerr << "跳过无法解析的预订记录 (第 " << lineNumber << " 行): " << e.what() << std::endl;
+                rejectedLines.emplace_back(begin, end);
+            }
+        });
     }
     catch (std::exception& e) {
         throw std::runtime_error("加载预订文件失败: " + std::string(e.what()));
     }
+    rebuildIndex();
+}
+
+// 私有: 助手: 依据 reservations 重建预订 ID 索引
+void ReservationManager::rebuildIndex() {
+    keyOrderValid = false;
+    idIndex.clear();
+    idIndex.reserve(reservations.size());
+    for (size_t i = 0; i < reservations.size(); i++) {
+        idIndex.emplace(reservations[i].getReservationID(), i);   // 重复键保留第一条, 与线性查找一致
+    }
 }
 
 // 私有: 助手: 将预订数据保存到文件
@@ -55,9 +84,10 @@ void ReservationManager::saveToFile() {
     for (const auto& reservation : reservations) {
         lines.push_back(reservation.toCSV());
     }
+    lines.insert(lines.end(), rejectedLines.begin(), rejectedLines.end());     // 无法解析的行原样写回
 
     try {
-        fileHandler.writeCSV(filePath, lines);
+        fileHandler.writeCSV(filePath, std::move(lines));
     } catch (std::exception& e) {
         throw std::runtime_error("保存预订文件失败: " + std::string(e.what()));
     }
@@ -74,9 +104,27 @@ bool ReservationManager::isAutoSaveEnabled() const {
 
 // 助手: 检查自动保存标志以决定是否需要保存
 void ReservationManager::saveIfNeeded() {
-    if (autoSave) {
-        saveToFile();
+    if (!autoSave) {
+        return;
     }
+    if (groupDepth > 0) {
+        groupDirty = true;
+        return;
+    }
+    saveToFile();
+}
+
+// 组提交: 可嵌套, 只有最外层结束时才落盘
+void ReservationManager::beginGroupCommit() {
+    groupDepth++;
+}
+
+void ReservationManager::endGroupCommit() {
+    if (groupDepth == 0 || --groupDepth > 0 || !groupDirty) {
+        return;
+    }
+    groupDirty = false;
+    saveToFile();
 }
 
 // 从已加载的预订中建立队列
@@ -142,9 +190,10 @@ void ReservationManager::rebuildQueueForISBN(const std::string &isbn) {
     reservationQueues.erase(isbn);
 
     // 收集此 ISBN 的活跃预订
+    Symbol isbnSymbol = SymbolTable::getInstance().find(isbn);
     std::vector<Reservation*> isbnReservations;
     for (auto& reservation : reservations) {
-        if (reservation.getISBN() == isbn && reservation.getIsActive()) {
+        if (reservation.getISBNSymbol() == isbnSymbol && reservation.getIsActive()) {
             isbnReservations.push_back(&reservation);
         }
     }
@@ -183,13 +232,8 @@ std::string ReservationManager::getNextInQueue(const std::string& isbn) const {
 
 // 获取预订在其队列中的位置 (1-indexed)
 int ReservationManager::getQueuePosition(const std::string& reservationID) const {
-    const Reservation* res = nullptr;
-    for (const auto& reservation : reservations) {
-        if (reservation.getReservationID() == reservationID) {
-            res = &reservation;
-            break;
-        }
-    }
+    auto indexIt = idIndex.find(reservationID);
+    const Reservation* res = indexIt == idIndex.end() ? nullptr : &reservations[indexIt->second];
 
     if (res == nullptr || !res->getIsActive()) {
         return -1;      // 未找到或无效
@@ -242,6 +286,8 @@ bool ReservationManager::addReservation(const Reservation& reservation) {
         return false;
     }
     reservations.push_back(reservation);
+    keyOrderValid = false;
+    idIndex[reservation.getReservationID()] = reservations.size() - 1;
 
     if (reservation.getIsActive()) {
         addToQueue(reservation.getISBN(), reservation.getReservationID());
@@ -282,15 +328,16 @@ bool ReservationManager::updateReservation(const Reservation& reservation) {
 
 // 删除预订
 bool ReservationManager::deleteReservation(const Reservation& reservation) {
-    auto it = std::find_if(reservations.begin(), reservations.end(),
-        [&](const Reservation& res) { return res.getReservationID() == reservation.getReservationID(); });
+    auto indexIt = idIndex.find(reservation.getReservationID());
 
-    if (it != reservations.end()) {
+    if (indexIt != idIndex.end()) {
+        auto it = reservations.begin() + indexIt->second;
         if (it->getIsActive()) {
             removeFromQueue(it->getISBN(), reservation.getReservationID());
         }
 
         reservations.erase(it);
+        rebuildIndex();     // 删除后其后预订下标前移
         if (autoSave) {
             saveToFile();
         }
@@ -301,20 +348,20 @@ bool ReservationManager::deleteReservation(const Reservation& reservation) {
 
 // 以预订 ID 查找预订
 Reservation* ReservationManager::findByReservationID(const std::string &reservationID) {
-    for (auto& reservation : reservations) {
-        if (reservation.getReservationID() == reservationID) {
-            return &reservation;
-        }
+    auto it = idIndex.find(reservationID);
+    if (it == idIndex.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return &reservations[it->second];
 }
 
 // 以会员 ID 查找预订
 std::vector<const Reservation*> ReservationManager::findByMemberID(const std::string& memberID) {
     std::vector<const Reservation*> results;
 
+    Symbol memberSymbol = SymbolTable::getInstance().find(memberID);
     for (const auto& reservation : reservations) {
-        if (reservation.getMemberID() == memberID) {
+        if (reservation.getMemberSymbol() == memberSymbol) {
             results.push_back(&reservation);
         }
     }
@@ -325,8 +372,9 @@ std::vector<const Reservation*> ReservationManager::findByMemberID(const std::st
 std::vector<const Reservation*> ReservationManager::findByISBN(const std::string& isbn) {
     std::vector<const Reservation*> results;
 
+    Symbol isbnSymbol = SymbolTable::getInstance().find(isbn);
     for (const auto& reservation : reservations) {
-        if (reservation.getISBN() == isbn) {
+        if (reservation.getISBNSymbol() == isbnSymbol) {
             results.push_back(&reservation);
         }
     }
@@ -334,11 +382,16 @@ std::vector<const Reservation*> ReservationManager::findByISBN(const std::string
 }
 
 // 以预订日期查找预订
+// 查询日期只解析一次, 之后逐条比较天数
 std::vector<const Reservation*> ReservationManager::findByReservationDate(const std::string& reservationDate) {
     std::vector<const Reservation*> results;
 
+    Date date;
+    if (!Date::parse(reservationDate.data(), reservationDate.data() + reservationDate.size(), date)) {
+        return results;
+    }
     for (const auto& reservation : reservations) {
-        if (reservation.getReservationDate() == reservationDate) {
+        if (reservation.getReservationDate() == date) {
             results.push_back(&reservation);
         }
     }
@@ -360,8 +413,13 @@ std::vector<const Reservation*> ReservationManager::findActiveReservations() {
 // 预约图书
 std::string ReservationManager::reserveBook(const std::string& memberID, const std::string& isbn) {
     MemberManager memberManager;
-    Member* member = memberManager.findMemberByID(memberID);
     BookManager bookManager;
+    return reserveBook(memberManager, bookManager, memberID, isbn);
+}
+
+std::string ReservationManager::reserveBook(MemberManager& memberManager, BookManager& bookManager,
+                                            const std::string& memberID, const std::string& isbn) {
+    Member* member = memberManager.findMemberByID(memberID);
     Book* book = bookManager.findBookByISBN(isbn);
 
     if (!member || !book) {
@@ -372,10 +430,13 @@ std::string ReservationManager::reserveBook(const std::string& memberID, const s
     }
 
     // 避免为同一会员和 ISBN 创建重复预订
+    const SymbolTable& symbols = SymbolTable::getInstance();
+    Symbol memberSymbol = symbols.find(memberID);
+    Symbol isbnSymbol = symbols.find(isbn);
     for (const auto& reservation : reservations) {
         if (reservation.getIsActive() &&
-            reservation.getMemberID() == memberID &&
-            reservation.getISBN() == isbn) {
+            reservation.getMemberSymbol() == memberSymbol &&
+            reservation.getISBNSymbol() == isbnSymbol) {
             return "0";
         }
     }
@@ -388,7 +449,7 @@ std::string ReservationManager::reserveBook(const std::string& memberID, const s
     std::string prefix = "R" + year + std::to_string(season);
     int maxSeq = 0;
     for (const auto& reservation : reservations) {
-        std::string id = reservation.getReservationID();
+        const std::string& id = reservation.getReservationID();
         if (id.rfind(prefix, 0) != 0) {
             continue;
         }
@@ -412,7 +473,9 @@ std::string ReservationManager::reserveBook(const std::string& memberID, const s
     oss << prefix << std::setw(5) << std::setfill('0') << (maxSeq + 1);
     std::string reservationID = oss.str();
 
-    Reservation reservation(reservationID, memberID, isbn, currentDate, true);
+    // 预订与书籍预订标记作为一次组提交落盘
+    UnitOfWork unitOfWork(&bookManager, nullptr, this);
+    Reservation reservation(reservationID, memberID, isbn, DateUtils::today(), true);
     if (!addReservation(reservation)) {
         return "0";
     }
@@ -424,22 +487,28 @@ std::string ReservationManager::reserveBook(const std::string& memberID, const s
         return "0";
     }
 
+    unitOfWork.commit();        // 落盘失败时抛出
     return reservationID;
 }
 
 // 取消预订
 std::string ReservationManager::cancelReservation(const std::string& reservationID) {
+    BookManager bookManager;
+    return cancelReservation(bookManager, reservationID);
+}
+
+std::string ReservationManager::cancelReservation(BookManager& bookManager, const std::string& reservationID) {
     Reservation* reservation = findByReservationID(reservationID);
     if (!reservation || !reservation->getIsActive()) {
         return "0";
     }
 
+    UnitOfWork unitOfWork(&bookManager, nullptr, this);
     std::string isbn = reservation->getISBN();
     removeFromQueue(isbn, reservationID);
     reservation->cancelReservation();
     saveIfNeeded();
 
-    BookManager bookManager;
     Book* book = bookManager.findBookByISBN(isbn);
     if (!book) {
         return "0";
@@ -454,6 +523,7 @@ std::string ReservationManager::cancelReservation(const std::string& reservation
         return "0";
     }
 
+    unitOfWork.commit();        // 落盘失败时抛出
     return reservationID;
 }
 
@@ -491,8 +561,42 @@ void ReservationManager::clearCache() {
 
 // 检查预订 ID 是否存在
 bool ReservationManager::isReservationIDExists(const std::string& reservationID) const {
-    return std::find_if(reservations.begin(), reservations.end(),
-        [&](const Reservation& reservation) { return reservation.getReservationID() == reservationID; }) != reservations.end();
+    return idIndex.find(reservationID) != idIndex.end();
+}
+
+// 私有: 助手: 取分页用的排序下标
+const std::vector<size_t>* ReservationManager::orderFor(int sortOrder) const {
+    if (sortOrder != 0 && sortOrder != 1) {
+        throw std::runtime_error("无效排序码");
+    }
+    if (sortOrder == 0) {
+        return nullptr;
+    }
+    if (!keyOrderValid) {
+        Pagination::sortByKey(reservations, &Reservation::getReservationID, keyOrder);
+        keyOrderValid = true;
+    }
+    return &keyOrder;
+}
+
+// 按偏移分页
+Page<Reservation> ReservationManager::getReservationsPage(size_t offset, size_t limit, int sortOrder) const {
+    return Pagination::makePage(reservations, orderFor(sortOrder), offset, limit, &Reservation::getReservationID);
+}
+
+// 按游标分页: 存储顺序时由主键索引定位游标, 主键顺序时二分查找
+Page<Reservation> ReservationManager::getReservationsPageAfter(const std::string& cursor, size_t limit, int sortOrder) const {
+    const std::vector<size_t>* order = orderFor(sortOrder);
+    size_t start = 0;
+    if (!cursor.empty()) {
+        if (order != nullptr) {
+            start = Pagination::positionAfter(reservations, *order, cursor, &Reservation::getReservationID);
+        } else {
+            auto it = idIndex.find(cursor);
+            start = it == idIndex.end() ? reservations.size() : it->second + 1;
+        }
+    }
+    return Pagination::makePage(reservations, order, start, limit, &Reservation::getReservationID);
 }
 
 // 批量操作 (RAII)
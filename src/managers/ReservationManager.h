@@ -3,14 +3,24 @@
 
 #include "../models/Reservation.h"
 #include "../utils/FileHandler.h"
+#include "../utils/Pagination.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <deque>
+#include <unordered_map>
+
+// 前向声明
+class MemberManager;
+class BookManager;
 
 class ReservationManager {
 private:
     std::vector<Reservation> reservations;
+    std::vector<std::string> rejectedLines;    // 加载时无法解析的原始行, 不参与查询, 保存时原样写回
+    std::unordered_map<std::string, size_t> idIndex;       // 预订 ID -> reservations 下标
+    mutable std::vector<size_t> keyOrder;                   // 按预订 ID排序的下标, 分页时按需生成
+    mutable bool keyOrderValid = false;
     std::string filePath;
     FileHandler fileHandler;
 
@@ -24,8 +34,13 @@ private:
     // 助手：将预订数据保存到文件
     void saveToFile();
 
+    // 助手：依据 reservations 重建预订 ID 索引
+    void rebuildIndex();
+
     // 用于批量操作
     bool autoSave = true;
+    int groupDepth = 0;         // 组提交嵌套层数, 大于 0 时只标记 groupDirty, 最外层结束时统一保存
+    bool groupDirty = false;
     void setAutoSave(bool enable = true);
     bool isAutoSaveEnabled() const;
 
@@ -38,6 +53,9 @@ private:
     bool removeFromQueue(const std::string& isbn, const std::string& reservationID);
     void rebuildQueueForISBN(const std::string& isbn);
 
+    // 助手: 取分页用的排序下标, 存储顺序时返回 nullptr
+    const std::vector<size_t>* orderFor(int sortOrder) const;
+
 public:
     // 构造函数
     explicit ReservationManager(const std::string& filePath = "../data/reservations.csv");
@@ -56,7 +74,10 @@ public:
 
     // 预订函数
     std::string reserveBook(const std::string& memberID, const std::string& isbn);
+    std::string reserveBook(MemberManager& memberManager, BookManager& bookManager,
+                            const std::string& memberID, const std::string& isbn);
     std::string cancelReservation(const std::string& reservationID);
+    std::string cancelReservation(BookManager& bookManager, const std::string& reservationID);
 
     // 队列管理函数
     std::string processNextReservation(const std::string& isbn);
@@ -71,9 +92,18 @@ public:
     int getTotalReservations() const;
     int getActiveReservations() const;
 
+    // 分页 (sortOrder: 0 存储顺序, 1 按预订 ID升序), 只返回指针, 不复制预订
+    Page<Reservation> getReservationsPage(size_t offset, size_t limit, int sortOrder = 0) const;
+    // 键集分页: 从游标 (上一页的 nextCursor) 之后开始, 游标为空时从头开始; 游标已失效时返回空页
+    Page<Reservation> getReservationsPageAfter(const std::string& cursor, size_t limit, int sortOrder = 0) const;
+
     // 实用方法
     void reload();          // 重新加载文件
     void clearCache();      // 清理文件处理器缓存
+
+    // 组提交 (由 UnitOfWork 调用): 期间的变更合并为一次整表保存
+    void beginGroupCommit();
+    void endGroupCommit();
     bool isReservationIDExists(const std::string& reservationID) const;
 
     // 批量操作 (RAII)
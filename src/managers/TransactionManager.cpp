@@ -3,17 +3,24 @@
 #include "TransactionManager.h"
 #include "BookManager.h"
 #include "MemberManager.h"
+#include "UnitOfWork.h"
 #include "../config/Config.h"
+#include "../utils/BinarySnapshot.h"
 #include "../utils/DateUtils.h"
 #include <algorithm>
 #include <cctype>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 // 构造函数
 TransactionManager::TransactionManager(const std::string& filePath)
-    : filePath(filePath), fileHandler() {
+    : filePath(filePath), journalPath(filePath + Config::JOURNAL_FILE_SUFFIX),
+      snapshotPath(filePath + Config::SNAPSHOT_FILE_SUFFIX), fileHandler() {
+    // 数据已解析为对象常驻内存, 不再另存一份原始行
+    fileHandler.setCacheEnabled(filePath, false);
+    fileHandler.setCacheEnabled(journalPath, false);
 
     if (!fileHandler.isFileExist(filePath)) {
         fileHandler.createFileIfNotExist(filePath);
@@ -28,20 +35,426 @@ TransactionManager::TransactionManager(const std::string& filePath)
 // 私有: 助手: 从文件加载交易数据
 void TransactionManager::loadFromFile() {
     transactions.clear();
+    rejectedLines.clear();
 
-    try {
-        auto lines = fileHandler.readCSV(filePath);
+    if (loadFromSnapshot()) {
+        rebuildIndex();
+        replayJournal();
+        return;
+    }
 
-        // 跳过表头(第一行)
-        for (size_t i = 1; i < lines.size(); i++) {
-            if (!lines[i].empty()) {
-                transactions.push_back(Transaction::fromCSV(lines[i]));
+    try {
+        // 逐行流式解析, 字段直接从读缓冲区构造对象
+        bool isHeader = true;
+        size_t lineNumber = 0;
+        fileHandler.forEachLine(filePath, [&](const char* begin, const char* end) {
+            lineNumber++;
+            // 跳过表头(第一行)
+            if (isHeader) {
+                isHeader = false;
+                return;
             }
-        }
+            if (begin == end) {
+                return;
+            }
+            // 无法解析的行 (如日期格式错误) 不载入, 保留原文, 避免保存时被改写或丢失
+            try {
+                transactions.push_back(Transaction::fromCSV(begin, end));
+            } catch (std::exception& e) {
+                std::cerr << "跳过无法解析的交易记录 (第 " << lineNumber << " 行): " << e.what() << std::endl;
+                rejectedLines.emplace_back(begin, end);
+            }
+        });
     }
     catch (std::exception& e) {
         throw std::runtime_error("Failed to load transactions file: " + std::string(e.what()));
     }
+    saveSnapshot();         // 快照缺失或过期, 重新生成供下次启动使用
+    rebuildIndex();
+
+    replayJournal();
+}
+
+// 私有: 助手: 从二进制快照加载交易数据
+// 列顺序与 CSV 相同; 快照损坏时清空已读数据并回退到 CSV
+bool TransactionManager::loadFromSnapshot() {
+    if (!Config::getInstance().isBinarySnapshotEnabled() ||
+        !BinarySnapshot::isFresh(snapshotPath, filePath)) {
+        return false;
+    }
+
+    try {
+        BinarySnapshot::Reader reader(snapshotPath);
+        if (reader.columnCount() != 9) {
+            return false;
+        }
+        // 各列类型须与 saveSnapshot 写出的一致, 否则按列读取会越界
+        // 字符串列可为 STRING 或 DICT; 日期列也接受旧快照中的字典列 (由 dateAt 按字符串解析)
+        for (size_t c = 0; c < 9; c++) {
+            BinarySnapshot::ColumnType type = reader.columnType(c);
+            bool isString = type == BinarySnapshot::STRING || type == BinarySnapshot::DICT;
+            bool expected;
+            if (c < 3) {
+                expected = isString;
+            } else if (c < 6) {
+                expected = type == BinarySnapshot::DATE || isString;
+            } else if (c == 7) {
+                expected = type == BinarySnapshot::DOUBLE;
+            } else {
+                expected = type == BinarySnapshot::INT32;
+            }
+            if (!expected) {
+                throw std::runtime_error("快照第 " + std::to_string(c) + " 列类型不符");
+            }
+        }
+
+        size_t rows = reader.rowCount();
+        transactions.reserve(rows);
+        for (size_t i = 0; i < rows; i++) {
+            transactions.emplace_back(
+                reader.stringAt(0, i).toString(),
+                reader.stringAt(1, i).toString(),
+                reader.stringAt(2, i).toString(),
+                reader.dateAt(3, i),
+                reader.dateAt(4, i),
+                reader.dateAt(5, i),
+                reader.intAt(6, i),
+                reader.doubleAt(7, i),
+                reader.intAt(8, i) != 0);
+        }
+        return true;
+    } catch (std::exception& e) {
+        std::cerr << "交易快照不可用, 改为读取 CSV: " << e.what() << std::endl;
+        transactions.clear();
+        return false;
+    }
+}
+
+// 私有: 助手: 按列写出二进制快照, 失败不影响 CSV
+void TransactionManager::saveSnapshot() {
+    // 快照无法表示未解析的行, 有这样的行时只用 CSV, 旧快照因 CSV 已变化而失效
+    if (!Config::getInstance().isBinarySnapshotEnabled() || !rejectedLines.empty()) {
+        return;
+    }
+
+    size_t rows = transactions.size();
+    std::vector<std::string> ids, memberIDs, isbns;
+    std::vector<Date> borrowDates, dueDates, returnDates;
+    std::vector<int32_t> renewCounts, returned;
+    std::vector<double> fines;
+    ids.reserve(rows);
+    memberIDs.reserve(rows);
+    isbns.reserve(rows);
+    borrowDates.reserve(rows);
+    dueDates.reserve(rows);
+    returnDates.reserve(rows);
+    renewCounts.reserve(rows);
+    returned.reserve(rows);
+    fines.reserve(rows);
+
+    for (const auto& transaction : transactions) {
+        ids.push_back(transaction.getTransactionID());
+        memberIDs.push_back(transaction.getUserID());
+        isbns.push_back(transaction.getISBN());
+        borrowDates.push_back(transaction.getBorrowDate());
+        dueDates.push_back(transaction.getDueDate());
+        returnDates.push_back(transaction.getReturnDate());
+        renewCounts.push_back(transaction.getRenewCount());
+        fines.push_back(transaction.getFine());
+        returned.push_back(transaction.haveReturned() ? 1 : 0);
+    }
+
+    try {
+        BinarySnapshot::Writer writer(rows);
+        writer.addStringColumn(ids, false);
+        writer.addStringColumn(memberIDs, true);
+        writer.addStringColumn(isbns, true);
+        writer.addDateColumn(borrowDates);
+        writer.addDateColumn(dueDates);
+        writer.addDateColumn(returnDates);
+        writer.addIntColumn(renewCounts);
+        writer.addDoubleColumn(fines);
+        writer.addIntColumn(returned);
+        writer.writeTo(snapshotPath, filePath);
+    } catch (std::exception& e) {
+        std::cerr << "写入交易快照失败: " << e.what() << std::endl;
+    }
+}
+
+// 私有: 助手: 依据 transactions 重建交易 ID 索引及二级索引
+void TransactionManager::rebuildIndex() {
+    keyOrderValid = false;
+    historyRevision++;
+    idIndex.clear();
+    memberSlots.clear();
+    isbnSlots.clear();
+    activeSlots.clear();
+    activeByDueDate.clear();
+    borrowDateOrder.clear();
+    dueDateOrder.clear();
+    returnDateOrder.clear();
+
+    idIndex.reserve(transactions.size());
+    borrowDateOrder.reserve(transactions.size());
+    dueDateOrder.reserve(transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++) {
+        idIndex.emplace(transactions[i].getTransactionID(), i);   // 重复键保留第一条, 与线性查找一致
+        indexSecondary(i, false);
+
+        // 日期索引先整体收集再排序一次, 避免逐条有序插入
+        borrowDateOrder.emplace_back(transactions[i].getBorrowDate(), i);
+        dueDateOrder.emplace_back(transactions[i].getDueDate(), i);
+        if (transactions[i].haveReturned()) {
+            returnDateOrder.emplace_back(transactions[i].getReturnDate(), i);
+        }
+    }
+    std::sort(borrowDateOrder.begin(), borrowDateOrder.end());
+    std::sort(dueDateOrder.begin(), dueDateOrder.end());
+    std::sort(returnDateOrder.begin(), returnDateOrder.end());
+}
+
+// 私有: 助手: 将一条交易加入二级索引
+void TransactionManager::indexSecondary(size_t slot, bool withDates) {
+    const Transaction& transaction = transactions[slot];
+
+    // 新交易总是追加在末尾, 通常直接落在列表尾部
+    std::vector<size_t>& byMember = memberSlots[transaction.getUserSymbol()];
+    byMember.insert(std::lower_bound(byMember.begin(), byMember.end(), slot), slot);
+    std::vector<size_t>& byISBN = isbnSlots[transaction.getISBNSymbol()];
+    byISBN.insert(std::lower_bound(byISBN.begin(), byISBN.end(), slot), slot);
+
+    if (!transaction.haveReturned()) {
+        activeSlots.set(slot);
+        activeByDueDate.emplace(transaction.getDueDate(), slot);
+    }
+
+    if (!withDates) {
+        return;
+    }
+    // 新交易的日期通常是最晚的, 多数情况下直接追加在末尾
+    auto insertDate = [slot](DateOrder& order, Date date) {
+        std::pair<Date, size_t> entry(date, slot);
+        if (order.empty() || order.back() < entry) {
+            order.push_back(std::move(entry));
+        } else {
+            order.insert(std::lower_bound(order.begin(), order.end(), entry), std::move(entry));
+        }
+    };
+    insertDate(borrowDateOrder, transaction.getBorrowDate());
+    insertDate(dueDateOrder, transaction.getDueDate());
+    if (transaction.haveReturned()) {
+        insertDate(returnDateOrder, transaction.getReturnDate());
+    }
+}
+
+// 私有: 助手: 将一条交易移出二级索引
+void TransactionManager::unindexSecondary(size_t slot) {
+    const Transaction& transaction = transactions[slot];
+
+    auto removeSlot = [slot](std::unordered_map<Symbol, std::vector<size_t>>& index, Symbol key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return;
+        }
+        auto pos = std::lower_bound(it->second.begin(), it->second.end(), slot);
+        if (pos != it->second.end() && *pos == slot) {
+            it->second.erase(pos);
+        }
+        if (it->second.empty()) {
+            index.erase(it);
+        }
+    };
+    removeSlot(memberSlots, transaction.getUserSymbol());
+    removeSlot(isbnSlots, transaction.getISBNSymbol());
+
+    if (activeSlots.test(slot)) {
+        activeSlots.reset(slot);
+        auto range = activeByDueDate.equal_range(transaction.getDueDate());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == slot) {
+                activeByDueDate.erase(it);
+                break;
+            }
+        }
+    }
+
+    auto eraseDate = [slot](DateOrder& order, Date date) {
+        std::pair<Date, size_t> entry(date, slot);
+        auto pos = std::lower_bound(order.begin(), order.end(), entry);
+        if (pos != order.end() && *pos == entry) {
+            order.erase(pos);
+        }
+    };
+    eraseDate(borrowDateOrder, transaction.getBorrowDate());
+    eraseDate(dueDateOrder, transaction.getDueDate());
+    if (transaction.haveReturned()) {
+        eraseDate(returnDateOrder, transaction.getReturnDate());
+    }
+}
+
+// 私有: 助手: 由交易指针求其下标
+size_t TransactionManager::slotOf(const Transaction* transaction) const {
+    return static_cast<size_t>(transaction - transactions.data());
+}
+
+// 私有: 助手: 覆盖一条交易并维护二级索引
+void TransactionManager::replaceTransaction(Transaction& existing, const Transaction& transaction) {
+    if (existing.getUserSymbol() != transaction.getUserSymbol() ||
+        existing.getISBNSymbol() != transaction.getISBNSymbol()) {
+        historyRevision++;
+    }
+    unindexSecondary(slotOf(&existing));
+    existing = transaction;
+    indexSecondary(slotOf(&existing));
+}
+
+// 私有: 助手: 删除一条交易; 只移除该交易的索引项, 其后交易在各索引中的下标减一, 各索引仍保持有序
+void TransactionManager::eraseTransaction(size_t slot) {
+    unindexSecondary(slot);
+    std::string transactionID = transactions[slot].getTransactionID();
+    idIndex.erase(transactionID);
+    transactions.erase(transactions.begin() + slot);
+
+    for (auto& entry : idIndex) {
+        if (entry.second > slot) {
+            entry.second--;
+        }
+    }
+    // 索引只保留重复 ID 的第一条; 删除的正是它时, 其后的同 ID 交易接替
+    for (size_t i = slot; i < transactions.size(); i++) {
+        if (transactions[i].getTransactionID() == transactionID) {
+            idIndex.emplace(transactionID, i);
+            break;
+        }
+    }
+    auto shiftSlots = [slot](std::unordered_map<Symbol, std::vector<size_t>>& index) {
+        for (auto& entry : index) {
+            for (auto it = std::upper_bound(entry.second.begin(), entry.second.end(), slot);
+                 it != entry.second.end(); ++it) {
+                --*it;
+            }
+        }
+    };
+    shiftSlots(memberSlots);
+    shiftSlots(isbnSlots);
+
+    activeSlots.erase(slot);
+    for (auto& entry : activeByDueDate) {
+        if (entry.second > slot) {
+            entry.second--;
+        }
+    }
+
+    // 同一日期内按下标排序, 统一减一后顺序不变
+    for (DateOrder* order : {&borrowDateOrder, &dueDateOrder, &returnDateOrder}) {
+        for (auto& entry : *order) {
+            if (entry.second > slot) {
+                entry.second--;
+            }
+        }
+    }
+
+    keyOrderValid = false;
+    historyRevision++;
+}
+
+// 私有: 助手: 在快照之上重放日志
+// 日志格式: "U,<交易 CSV>" 表示插入或覆盖, "D,<交易 ID>" 表示删除
+// 记录以交易 ID 为键且可重复应用, 因此合并中途崩溃后重放仍然正确
+// 每条记录带校验码 (FileHandler::forEachRecord), 崩溃时写了一半的尾记录校验不通过, 重放后从文件中截掉
+void TransactionManager::replayJournal() {
+    journalEntries = 0;
+    if (!fileHandler.isFileExist(journalPath)) {
+        return;
+    }
+
+    auto applyRecord = [&](const char* begin, const char* end) {
+        if (end - begin < 3 || begin[1] != ',') {
+            return;
+        }
+        const char* payload = begin + 2;
+
+        if (begin[0] == 'U') {
+            Transaction transaction = Transaction::fromCSV(payload, end);
+            Transaction* existing = findByTransactionID(transaction.getTransactionID());
+            if (existing != nullptr) {
+                replaceTransaction(*existing, transaction);
+            } else {
+                transactions.push_back(transaction);
+                keyOrderValid = false;
+                idIndex[transaction.getTransactionID()] = transactions.size() - 1;
+                indexSecondary(transactions.size() - 1);
+            }
+        } else if (begin[0] == 'D') {
+            auto it = idIndex.find(std::string(payload, end));
+            if (it != idIndex.end()) {
+                eraseTransaction(it->second);
+            }
+        } else {
+            return;
+        }
+        journalEntries++;
+    };
+
+    try {
+        fileHandler.forEachRecord(journalPath, applyRecord);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to load transactions journal: " + std::string(e.what()));
+    }
+}
+
+// 私有: 助手: 追加一条日志记录, 达到阈值则合并; 组提交期间只暂存
+void TransactionManager::appendJournal(char op, const std::string& payload) {
+    if (groupDepth > 0) {
+        pendingJournal.push_back(std::string(1, op) + "," + payload);
+        return;
+    }
+
+    try {
+        fileHandler.appendRecord(journalPath, std::string(1, op) + "," + payload);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to append transactions journal: " + std::string(e.what()));
+    }
+
+    if (++journalEntries >= Config::JOURNAL_COMPACT_THRESHOLD) {
+        compactJournal();
+    }
+}
+
+// 组提交: 可嵌套, 只有最外层结束时才落盘
+void TransactionManager::beginGroupCommit() {
+    groupDepth++;
+}
+
+void TransactionManager::endGroupCommit() {
+    if (groupDepth == 0 || --groupDepth > 0 || pendingJournal.empty()) {
+        return;
+    }
+
+    std::vector<std::string> records;
+    records.swap(pendingJournal);
+    try {
+        fileHandler.appendRecords(journalPath, records);
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to append transactions journal: " + std::string(e.what()));
+    }
+
+    journalEntries += static_cast<int>(records.size());
+    if (journalEntries >= Config::JOURNAL_COMPACT_THRESHOLD) {
+        compactJournal();
+    }
+}
+
+// 将日志合并回快照: 先写快照再清空日志
+void TransactionManager::compactJournal() {
+    saveToFile();
+    try {
+        fileHandler.writeCSV(journalPath, {});
+    } catch (std::exception& e) {
+        throw std::runtime_error("Failed to truncate transactions journal: " + std::string(e.what()));
+    }
+    journalEntries = 0;
+    pendingJournal.clear();        // 暂存记录已包含在新快照中
 }
 
 // 私有: 助手: 将交易数据保存到文件
@@ -54,12 +467,14 @@ void TransactionManager::saveToFile() {
     for (const auto& transaction : transactions) {
         lines.push_back(transaction.toCSV());
     }
+    lines.insert(lines.end(), rejectedLines.begin(), rejectedLines.end());     // 无法解析的行原样写回
 
     try {
-        fileHandler.writeCSV(filePath, lines);
+        fileHandler.writeCSV(filePath, std::move(lines));
     } catch (std::exception& e) {
         throw std::runtime_error("Failed to save transactions file: " + std::string(e.what()));
     }
+    saveSnapshot();
 }
 
 // 私有: 辅助: 设置自动保存标志
@@ -71,10 +486,17 @@ bool TransactionManager::isAutoSaveEnabled() const {
     return autoSave;
 }
 
-// 助手: 检查自动保存标志决定是否需要保存
-void TransactionManager::saveIfNeeded() {
+// 助手: 检查自动保存标志决定是否需要记录日志
+// 批量操作期间不写日志, 由批量结束时的合并统一落盘
+void TransactionManager::logUpsert(const Transaction& transaction) {
+    if (autoSave) {
+        appendJournal('U', transaction.toCSV());
+    }
+}
+
+void TransactionManager::logDelete(const std::string& transactionID) {
     if (autoSave) {
-        saveToFile();
+        appendJournal('D', transactionID);
     }
 }
 
@@ -114,15 +536,38 @@ std::string TransactionManager::generateTransactionID() const {
 }
 
 int TransactionManager::getActiveCountForMember(const std::string& memberID) const {
+    auto it = memberSlots.find(SymbolTable::getInstance().find(memberID));
+    if (it == memberSlots.end()) {
+        return 0;
+    }
+
     int count = 0;
-    for (const auto& transaction : transactions) {
-        if (transaction.getUserID() == memberID && !transaction.haveReturned()) {
+    for (size_t slot : it->second) {
+        if (!transactions[slot].haveReturned()) {
             count++;
         }
     }
     return count;
 }
 
+// 私有: 助手: 查找会员对某 ISBN 的未归还交易
+const Transaction* TransactionManager::findActiveLoan(const std::string& memberID, const std::string& isbn) const {
+    const SymbolTable& symbols = SymbolTable::getInstance();
+    auto it = memberSlots.find(symbols.find(memberID));
+    if (it == memberSlots.end()) {
+        return nullptr;
+    }
+
+    Symbol isbnSymbol = symbols.find(isbn);
+    for (size_t slot : it->second) {
+        const Transaction& t = transactions[slot];
+        if (t.getISBNSymbol() == isbnSymbol && !t.haveReturned()) {
+            return &t;
+        }
+    }
+    return nullptr;
+}
+
 // 新增一条交易
 bool TransactionManager::addTransaction(const Transaction& transaction) {
     // 检查交易ID是否已存在
@@ -130,7 +575,10 @@ bool TransactionManager::addTransaction(const Transaction& transaction) {
         return false;
     }
     transactions.push_back(transaction);
-    saveIfNeeded();
+    keyOrderValid = false;
+    idIndex[transaction.getTransactionID()] = transactions.size() - 1;
+    indexSecondary(transactions.size() - 1);
+    logUpsert(transaction);
     return true;
 }
 
@@ -141,19 +589,18 @@ bool TransactionManager::updateTransaction(const Transaction& transaction) {
     if (existingTransaction == nullptr) {
         return false;
     }
-    *existingTransaction = transaction;
-    saveIfNeeded();
+    replaceTransaction(*existingTransaction, transaction);
+    logUpsert(*existingTransaction);
     return true;
 }
 
 // 以交易 ID 删除交易
 bool TransactionManager::deleteTransaction(const std::string& transactionID) {
-    auto it = std::find_if(transactions.begin(), transactions.end(),
-        [&](const Transaction& trans) { return trans.getTransactionID() == transactionID; });
+    auto it = idIndex.find(transactionID);
 
-    if (it != transactions.end()) {
-        transactions.erase(it);
-        saveIfNeeded();
+    if (it != idIndex.end()) {
+        eraseTransaction(it->second);
+        logDelete(transactionID);
         return true;
     }
     return false;
@@ -161,21 +608,22 @@ bool TransactionManager::deleteTransaction(const std::string& transactionID) {
 
 // 以交易 ID 查找交易
 Transaction* TransactionManager::findByTransactionID(const std::string& transactionID) {
-    for (auto& transaction : transactions) {
-        if (transaction.getTransactionID() == transactionID) {
-            return &transaction;
-        }
+    auto it = idIndex.find(transactionID);
+    if (it == idIndex.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return &transactions[it->second];
 }
 
 // 以会员 ID 查找交易
 std::vector<const Transaction*> TransactionManager::findByMemberID(const std::string& memberID) {
     std::vector<const Transaction*> results;
 
-    for (const auto& transaction : transactions) {
-        if (transaction.getUserID() == memberID) {
-            results.push_back(&transaction);
+    auto it = memberSlots.find(SymbolTable::getInstance().find(memberID));
+    if (it != memberSlots.end()) {
+        results.reserve(it->second.size());
+        for (size_t slot : it->second) {
+            results.push_back(&transactions[slot]);
         }
     }
     return results;
@@ -185,74 +633,135 @@ std::vector<const Transaction*> TransactionManager::findByMemberID(const std::st
 std::vector<const Transaction*> TransactionManager::findByISBN(const std::string& isbn) {
     std::vector<const Transaction*> results;
 
-    for (const auto& transaction : transactions) {
-        if (transaction.getISBN() == isbn) {
-            results.push_back(&transaction);
+    auto it = isbnSlots.find(SymbolTable::getInstance().find(isbn));
+    if (it != isbnSlots.end()) {
+        results.reserve(it->second.size());
+        for (size_t slot : it->second) {
+            results.push_back(&transactions[slot]);
         }
     }
     return results;
 }
 
 // 以借出日查找交易
-std::vector<const Transaction*> TransactionManager::findByBorrowDate(const std::string& borrowDate) {
-    std::vector<const Transaction*> results;
-
-    for (const auto& transaction : transactions) {
-        if (transaction.getBorrowDate() == borrowDate) {
-            results.push_back(&transaction);
-        }
+std::vector<const Transaction*> TransactionManager::findByBorrowDate(Date borrowDate) {
+    if (borrowDate.empty()) {
+        return std::vector<const Transaction*>();
     }
-    return results;
+    return findByDateRange(0, borrowDate, borrowDate);
 }
 
 // 以到期日查找交易
-std::vector<const Transaction*> TransactionManager::findByDueDate(const std::string& dueDate) {
-    std::vector<const Transaction*> results;
-
-    for (const auto& transaction : transactions) {
-        if (transaction.getDueDate() == dueDate) {
-            results.push_back(&transaction);
-        }
+std::vector<const Transaction*> TransactionManager::findByDueDate(Date dueDate) {
+    if (dueDate.empty()) {
+        return std::vector<const Transaction*>();
     }
-    return results;
+    return findByDateRange(1, dueDate, dueDate);
 }
 
 // 以归还日查找交易
-std::vector<const Transaction*> TransactionManager::findByReturnDate(const std::string& returnDate) {
-    std::vector<const Transaction*> results;
-
-    for (const auto& transaction : transactions) {
-        if (transaction.getReturnDate() == returnDate) {
-            results.push_back(&transaction);
-        }
+std::vector<const Transaction*> TransactionManager::findByReturnDate(Date returnDate) {
+    if (returnDate.empty()) {
+        return std::vector<const Transaction*>();
     }
-    return results;
+    return findByDateRange(2, returnDate, returnDate);
 }
 
 // 查找有效交易
 std::vector<const Transaction*> TransactionManager::findActiveTransactions() {
     std::vector<const Transaction*> results;
 
-    for (const auto& transaction : transactions) {
-        if (!transaction.haveReturned()) {
-            results.push_back(&transaction);
-        }
-    }
+    results.reserve(activeSlots.count());
+    activeSlots.forEach([&](size_t slot) {
+        results.push_back(&transactions[slot]);
+        return true;
+    });
     return results;
 }
 
 // 查找逾期交易
+// 到期日不晚于今天的未归还交易即为逾期 (与 Transaction::isOverdue 一致), 直接取到期日索引的前缀
 std::vector<const Transaction*> TransactionManager::findOverdueTransactions() {
+    std::vector<size_t> slots;
+
+    auto last = activeByDueDate.upper_bound(DateUtils::today());
+    for (auto it = activeByDueDate.begin(); it != last; ++it) {
+        slots.push_back(it->second);
+    }
+    std::sort(slots.begin(), slots.end());
+
     std::vector<const Transaction*> results;
+    results.reserve(slots.size());
+    for (size_t slot : slots) {
+        results.push_back(&transactions[slot]);
+    }
+    return results;
+}
 
-    for (const auto& transaction : transactions) {
-        if (!transaction.haveReturned() && transaction.isOverdue()) {
-            results.push_back(&transaction);
-        }
+// 私有: 助手: 按日期字段码取日期索引
+const TransactionManager::DateOrder& TransactionManager::dateOrderFor(int dateField) const {
+    switch (dateField) {
+        case 0: return borrowDateOrder;
+        case 1: return dueDateOrder;
+        case 2: return returnDateOrder;
+        default: throw std::runtime_error("无效日期字段码");
+    }
+}
+
+// 私有: 助手: 日期区间 [from, to] 在日期索引中的下标范围 [first, last)
+std::pair<size_t, size_t> TransactionManager::dateBounds(const DateOrder& order, Date from, Date to) {
+    auto dateLess = [](const std::pair<Date, size_t>& entry, Date date) {
+        return entry.first < date;
+    };
+    auto dateGreater = [](Date date, const std::pair<Date, size_t>& entry) {
+        return date < entry.first;
+    };
+
+    auto first = from.empty() ? order.begin() : std::lower_bound(order.begin(), order.end(), from, dateLess);
+    auto last = to.empty() ? order.end() : std::upper_bound(first, order.end(), to, dateGreater);
+    return std::make_pair(static_cast<size_t>(first - order.begin()), static_cast<size_t>(last - order.begin()));
+}
+
+// 以日期区间查找交易
+std::vector<const Transaction*> TransactionManager::findByDateRange(int dateField, Date from, Date to) const {
+    const DateOrder& order = dateOrderFor(dateField);
+    std::pair<size_t, size_t> bounds = dateBounds(order, from, to);
+
+    std::vector<const Transaction*> results;
+    results.reserve(bounds.second - bounds.first);
+    for (size_t i = bounds.first; i < bounds.second; i++) {
+        results.push_back(&transactions[order[i].second]);
     }
     return results;
 }
 
+// 统计日期区间内的交易数, 只需两次二分查找
+size_t TransactionManager::countByDateRange(int dateField, Date from, Date to) const {
+    std::pair<size_t, size_t> bounds = dateBounds(dateOrderFor(dateField), from, to);
+    return bounds.second - bounds.first;
+}
+
+// 按日期顺序遍历区间内的交易
+void TransactionManager::forEachByDate(int dateField, Date from, Date to, bool newestFirst,
+                                       const std::function<bool(const Transaction&)>& onVisit) const {
+    const DateOrder& order = dateOrderFor(dateField);
+    std::pair<size_t, size_t> bounds = dateBounds(order, from, to);
+
+    if (newestFirst) {
+        for (size_t i = bounds.second; i > bounds.first; i--) {
+            if (!onVisit(transactions[order[i - 1].second])) {
+                return;
+            }
+        }
+    } else {
+        for (size_t i = bounds.first; i < bounds.second; i++) {
+            if (!onVisit(transactions[order[i].second])) {
+                return;
+            }
+        }
+    }
+}
+
 // 借一本书
 std::string TransactionManager::borrowBook(const std::string& memberID, const std::string& isbn) {
     MemberManager memberManager(Config::MEMBERS_FILE);
@@ -270,11 +779,13 @@ std::string TransactionManager::borrowBook(const std::string& memberID, const st
         return "0";
     }
 
-    std::string currentDate = DateUtils::getCurrentDate();
-    std::string dueDate = DateUtils::addDays(currentDate, 14);
+    // 交易与库存变更作为一次组提交落盘
+    UnitOfWork unitOfWork(&bookManager, this);
+    Date currentDate = DateUtils::today();
+    Date dueDate = currentDate.addDays(14);
     std::string transactionID = generateTransactionID();
 
-    Transaction transaction(transactionID, memberID, isbn, currentDate, dueDate, "", 0, 0.0, false);
+    Transaction transaction(transactionID, memberID, isbn, currentDate, dueDate, Date(), 0, 0.0, false);
     if (!addTransaction(transaction)) {
         return "0";
     }
@@ -284,6 +795,7 @@ std::string TransactionManager::borrowBook(const std::string& memberID, const st
         return "0";
     }
 
+    unitOfWork.commit();        // 落盘失败时抛出, 不能报告借阅成功
     return transactionID;
 }
 
@@ -302,11 +814,13 @@ std::string TransactionManager::borrowBook(MemberManager& memberManager, BookMan
         return "0";
     }
 
-    std::string currentDate = DateUtils::getCurrentDate();
-    std::string dueDate = DateUtils::addDays(currentDate, 14);
+    // 交易与库存变更作为一次组提交落盘
+    UnitOfWork unitOfWork(&bookManager, this);
+    Date currentDate = DateUtils::today();
+    Date dueDate = currentDate.addDays(14);
     std::string transactionID = generateTransactionID();
 
-    Transaction transaction(transactionID, memberID, isbn, currentDate, dueDate, "", 0, 0.0, false);
+    Transaction transaction(transactionID, memberID, isbn, currentDate, dueDate, Date(), 0, 0.0, false);
     if (!addTransaction(transaction)) {
         return "0";
     }
@@ -316,6 +830,7 @@ std::string TransactionManager::borrowBook(MemberManager& memberManager, BookMan
         return "0";
     }
 
+    unitOfWork.commit();        // 落盘失败时抛出, 不能报告借阅成功
     return transactionID;
 }
 
@@ -327,12 +842,16 @@ bool TransactionManager::returnBook(const std::string& transactionID) {
     }
 
     BookManager bookManager(Config::BOOKS_FILE);
+    UnitOfWork unitOfWork(&bookManager, this);
     if (!bookManager.returnBook(transaction->getISBN())) {
         return false;
     }
 
+    unindexSecondary(slotOf(transaction));
     transaction->returnBook();
-    saveIfNeeded();
+    indexSecondary(slotOf(transaction));
+    logUpsert(*transaction);
+    unitOfWork.commit();
     return true;
 }
 
@@ -342,26 +861,22 @@ bool TransactionManager::returnBook(BookManager& bookManager, const std::string&
         return false;
     }
 
+    UnitOfWork unitOfWork(&bookManager, this);
     if (!bookManager.returnBook(transaction->getISBN())) {
         return false;
     }
 
+    unindexSecondary(slotOf(transaction));
     transaction->returnBook();
-    saveIfNeeded();
+    indexSecondary(slotOf(transaction));
+    logUpsert(*transaction);
+    unitOfWork.commit();
     return true;
 }
 
 // 以会员 ID 和 ISBN 归还一本书
 bool TransactionManager::returnBook(const std::string& memberID, const std::string& isbn) {
-    const Transaction *transaction = nullptr;
-    for (const auto& t : transactions) {
-        if ( t.getUserID() == memberID &&
-             t.getISBN() == isbn &&
-             !t.haveReturned()) {
-            transaction = &t;
-            break;
-        }
-    }
+    const Transaction *transaction = findActiveLoan(memberID, isbn);
 
     if (transaction == nullptr) {
         return false;
@@ -371,15 +886,7 @@ bool TransactionManager::returnBook(const std::string& memberID, const std::stri
 }
 
 bool TransactionManager::returnBook(BookManager& bookManager, const std::string& memberID, const std::string& isbn) {
-    const Transaction *transaction = nullptr;
-    for (const auto& t : transactions) {
-        if ( t.getUserID() == memberID &&
-             t.getISBN() == isbn &&
-             !t.haveReturned()) {
-            transaction = &t;
-            break;
-        }
-    }
+    const Transaction *transaction = findActiveLoan(memberID, isbn);
 
     if (transaction == nullptr) {
         return false;
@@ -399,21 +906,15 @@ bool TransactionManager::renewBook(const std::string& transactionID) {
         return false;
     }
 
+    unindexSecondary(slotOf(transaction));
     transaction->renewBook();
-    saveIfNeeded();
+    indexSecondary(slotOf(transaction));
+    logUpsert(*transaction);
     return true;
 }
 
 bool TransactionManager::renewBook(const std::string& memberID, const std::string& isbn) {
-    const Transaction *transaction = nullptr;
-    for (const auto& t : transactions) {
-        if ( t.getUserID() == memberID &&
-             t.getISBN() == isbn &&
-             !t.haveReturned()) {
-            transaction = &t;
-            break;
-             }
-    }
+    const Transaction *transaction = findActiveLoan(memberID, isbn);
 
     if (transaction == nullptr) {
         return false;
@@ -430,9 +931,14 @@ std::vector<const Transaction*> TransactionManager::getMemberHistory(const std::
 // 获取一位会员的有效交易
 std::vector<const Transaction*> TransactionManager::getActiveTransactions(const std::string& memberID) {
     std::vector<const Transaction*> results;
-    for (const auto& transaction : transactions) {
-        if (transaction.getUserID() == memberID && !transaction.haveReturned()) {
-            results.push_back(&transaction);
+
+    auto it = memberSlots.find(SymbolTable::getInstance().find(memberID));
+    if (it == memberSlots.end()) {
+        return results;
+    }
+    for (size_t slot : it->second) {
+        if (!transactions[slot].haveReturned()) {
+            results.push_back(&transactions[slot]);
         }
     }
     return results;
@@ -455,24 +961,17 @@ int TransactionManager::getTotalTransactions() const {
 
 // 获取活跃交易数
 int TransactionManager::getActiveTransactionsCount() const {
-    int count = 0;
-    for (const auto& transaction : transactions) {
-        if (!transaction.haveReturned()) {
-            count++;
-        }
-    }
-    return count;
+    return static_cast<int>(activeSlots.count());
 }
 
 // 获取逾期交易数
 int TransactionManager::getOverdueTransactionsCount() const {
-    int count = 0;
-    for (const auto& transaction : transactions) {
-        if (!transaction.haveReturned() && transaction.isOverdue()) {
-            count++;
-        }
-    }
-    return count;
+    auto last = activeByDueDate.upper_bound(DateUtils::today());
+    return static_cast<int>(std::distance(activeByDueDate.begin(), last));
+}
+
+uint64_t TransactionManager::getHistoryRevision() const {
+    return historyRevision;
 }
 
 // 重新加载文件
@@ -487,8 +986,42 @@ void TransactionManager::clearCache() {
 
 // 检查交易 ID 是否存在
 bool TransactionManager::isTransactionIDExists(const std::string& transactionID) const {
-    return std::find_if(transactions.begin(), transactions.end(),
-        [&](const Transaction& transaction) { return transaction.getTransactionID() == transactionID; }) != transactions.end();
+    return idIndex.find(transactionID) != idIndex.end();
+}
+
+// 私有: 助手: 取分页用的排序下标
+const std::vector<size_t>* TransactionManager::orderFor(int sortOrder) const {
+    if (sortOrder != 0 && sortOrder != 1) {
+        throw std::runtime_error("无效排序码");
+    }
+    if (sortOrder == 0) {
+        return nullptr;
+    }
+    if (!keyOrderValid) {
+        Pagination::sortByKey(transactions, &Transaction::getTransactionID, keyOrder);
+        keyOrderValid = true;
+    }
+    return &keyOrder;
+}
+
+// 按偏移分页
+Page<Transaction> TransactionManager::getTransactionsPage(size_t offset, size_t limit, int sortOrder) const {
+    return Pagination::makePage(transactions, orderFor(sortOrder), offset, limit, &Transaction::getTransactionID);
+}
+
+// 按游标分页: 存储顺序时由主键索引定位游标, 主键顺序时二分查找
+Page<Transaction> TransactionManager::getTransactionsPageAfter(const std::string& cursor, size_t limit, int sortOrder) const {
+    const std::vector<size_t>* order = orderFor(sortOrder);
+    size_t start = 0;
+    if (!cursor.empty()) {
+        if (order != nullptr) {
+            start = Pagination::positionAfter(transactions, *order, cursor, &Transaction::getTransactionID);
+        } else {
+            auto it = idIndex.find(cursor);
+            start = it == idIndex.end() ? transactions.size() : it->second + 1;
+        }
+    }
+    return Pagination::makePage(transactions, order, start, limit, &Transaction::getTransactionID);
 }
 
 // 批量操作 (RAII)
@@ -509,7 +1042,7 @@ TransactionManager::BatchOperation::~BatchOperation() {
     }
 
     try {
-        transactionManager->saveToFile();
+        transactionManager->compactJournal();
         transactionManager->setAutoSave(originalAutoSave);
     } catch (...) {
         std::cerr << "在批量操作期间尝试保存交易时出错" << std::endl;
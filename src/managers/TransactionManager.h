@@ -2,8 +2,13 @@
 #define LIBRARY_MANAGEMENT_SYSTEM_TRANSACTIONMANAGER_H
 
 #include "../models/Transaction.h"
+#include "../utils/Bitmap.h"
 #include "../utils/FileHandler.h"
+#include "../utils/Pagination.h"
+#include <functional>
+#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // 前向声明
@@ -12,21 +17,60 @@ class BookManager;
 
 class TransactionManager {
 private:
+    // 日期有序索引: (日期, 交易下标) 按升序排列, 同日按存储顺序; 支持区间查询与区间计数
+    typedef std::vector<std::pair<Date, size_t>> DateOrder;
+
     std::vector<Transaction> transactions;
+    std::vector<std::string> rejectedLines;    // 加载时无法解析的原始行, 不参与查询, 保存时原样写回
+    std::unordered_map<std::string, size_t> idIndex;       // 交易 ID -> transactions 下标
+    mutable std::vector<size_t> keyOrder;                   // 按交易 ID排序的下标, 分页时按需生成
+    mutable bool keyOrderValid = false;
+    uint64_t historyRevision = 0;   // 交易被删除、重载或改动会员/ISBN 时递增; 追加和借还续借不变
+
+    // 二级索引 (下标均按升序保存, 结果顺序与 transactions 一致)
+    // 会员 ID 和 ISBN 以驻留句柄为键; 按字符串查询时先 find 句柄, 未驻留的键必然没有交易
+    std::unordered_map<Symbol, std::vector<size_t>> memberSlots;          // 会员 ID -> 交易下标
+    std::unordered_map<Symbol, std::vector<size_t>> isbnSlots;            // ISBN -> 交易下标
+    Bitmap activeSlots;                                                   // 未归还交易下标的位图
+    std::multimap<Date, size_t> activeByDueDate;                          // 到期日 -> 未归还交易下标
+    DateOrder borrowDateOrder;                                            // 全部交易按借出日
+    DateOrder dueDateOrder;                                               // 全部交易按到期日
+    DateOrder returnDateOrder;                                            // 已归还交易按归还日
     std::string filePath;
+    std::string journalPath;        // 追加写日志 (快照 + 日志尾 = 当前数据)
+    std::string snapshotPath;       // 可选的二进制列式快照, 与 CSV 内容一致时优先加载
+    int journalEntries = 0;         // 自上次合并以来的日志条数
+    int groupDepth = 0;             // 组提交嵌套层数, 大于 0 时日志记录暂存于 pendingJournal
+    std::vector<std::string> pendingJournal;
     FileHandler fileHandler;
 
     // 数据持久化
     void loadFromFile();
     void saveToFile();
+    bool loadFromSnapshot();    // 快照可用时从快照加载, 否则返回 false
+    void saveSnapshot();
+    void rebuildIndex();    // 依据 transactions 重建交易 ID 索引及二级索引
+
+    // 助手: 维护单条交易的二级索引, 修改交易前先移除, 修改后再加入
+    // 重建时日期索引另行整体排序, 此时 withDates 为 false
+    void indexSecondary(size_t slot, bool withDates = true);
+    void unindexSecondary(size_t slot);
+    size_t slotOf(const Transaction* transaction) const;
+    void replaceTransaction(Transaction& existing, const Transaction& transaction);
+    void eraseTransaction(size_t slot);     // 删除一条交易并就地调整各索引中其后交易的下标
+
+    // 日志: 每次变更只追加一条记录, 达到阈值后合并回快照
+    void replayJournal();
+    void appendJournal(char op, const std::string& payload);
 
     // 用于批量操作
     bool autoSave = true;
     void setAutoSave(bool enable = true);
     bool isAutoSaveEnabled() const;
 
-    // 助手: 检查自动保存标志决定是否需要保存
-    void saveIfNeeded();
+    // 助手: 检查自动保存标志决定是否需要记录日志
+    void logUpsert(const Transaction& transaction);
+    void logDelete(const std::string& transactionID);
 
     // 助手: 生成交易 ID
     std::string generateTransactionID() const;
@@ -34,6 +78,16 @@ private:
     // 助手: 对一位会员计算其活跃交易数
     int getActiveCountForMember(const std::string& memberID) const;
 
+    // 助手: 查找会员对某 ISBN 的未归还交易
+    const Transaction* findActiveLoan(const std::string& memberID, const std::string& isbn) const;
+
+    // 助手: 取分页用的排序下标, 存储顺序时返回 nullptr
+    const std::vector<size_t>* orderFor(int sortOrder) const;
+
+    // 助手: 按日期字段码取日期索引, 并求日期区间 [from, to] 在其中的下标范围
+    const DateOrder& dateOrderFor(int dateField) const;
+    static std::pair<size_t, size_t> dateBounds(const DateOrder& order, Date from, Date to);
+
 public:
     // 构造函数
     explicit TransactionManager(const std::string& filePath = "../data/transactions.csv");
@@ -47,12 +101,23 @@ public:
     Transaction* findByTransactionID(const std::string& transactionID);
     std::vector<const Transaction*> findByMemberID(const std::string& memberID);
     std::vector<const Transaction*> findByISBN(const std::string& isbn);
-    std::vector<const Transaction*> findByBorrowDate(const std::string& borrowDate);
-    std::vector<const Transaction*> findByDueDate(const std::string& dueDate);
-    std::vector<const Transaction*> findByReturnDate(const std::string& returnDate);
+    std::vector<const Transaction*> findByBorrowDate(Date borrowDate);     // 空日期返回空结果
+    std::vector<const Transaction*> findByDueDate(Date dueDate);
+    std::vector<const Transaction*> findByReturnDate(Date returnDate);
     std::vector<const Transaction*> findActiveTransactions();
     std::vector<const Transaction*> findOverdueTransactions();
 
+    // 日期区间查询
+    // dateField = 0 --> 借出日
+    // dateField = 1 --> 到期日
+    // dateField = 2 --> 归还日 (只含已归还交易)
+    // 区间 [from, to] 含两端, 任一端为空日期表示不限; 结果按日期升序, 同日按存储顺序
+    std::vector<const Transaction*> findByDateRange(int dateField, Date from, Date to) const;
+    size_t countByDateRange(int dateField, Date from, Date to) const;
+    // 按日期顺序遍历区间, newestFirst 为 true 时从晚到早; onVisit 返回 false 时停止
+    void forEachByDate(int dateField, Date from, Date to, bool newestFirst,
+                       const std::function<bool(const Transaction&)>& onVisit) const;
+
     // 交易函数
     std::string borrowBook(const std::string& memberID, const std::string& isbn);
     std::string borrowBook(MemberManager& memberManager, BookManager& bookManager,
@@ -74,10 +139,22 @@ public:
     int getTotalTransactions() const;
     int getActiveTransactionsCount() const;
     int getOverdueTransactionsCount() const;
+    // 借阅历史版本号: 版本不变时, 调用者可只处理上次之后追加在末尾的交易
+    uint64_t getHistoryRevision() const;
+
+    // 分页 (sortOrder: 0 存储顺序, 1 按交易 ID升序), 只返回指针, 不复制交易
+    Page<Transaction> getTransactionsPage(size_t offset, size_t limit, int sortOrder = 0) const;
+    // 键集分页: 从游标 (上一页的 nextCursor) 之后开始, 游标为空时从头开始; 游标已失效时返回空页
+    Page<Transaction> getTransactionsPageAfter(const std::string& cursor, size_t limit, int sortOrder = 0) const;
 
     // 实用方法
     void reload();          // 重新加载文件
     void clearCache();      // 清除文件处理器缓存
+    void compactJournal();  // 将日志合并回 CSV 快照并清空日志
+
+    // 组提交 (由 UnitOfWork 调用): 开始后日志只暂存在内存, 最外层结束时一次写出并同步
+    void beginGroupCommit();
+    void endGroupCommit();
     bool isTransactionIDExists(const std::string& transactionID) const;
 
     // 批量操作 (RAII)
@@ -0,0 +1,62 @@
+// UnitOfWork.h 实现
+
+#include "UnitOfWork.h"
+#include "BookManager.h"
+#include "MemberManager.h"
+#include "ReservationManager.h"
+#include "TransactionManager.h"
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+UnitOfWork::UnitOfWork(BookManager* bookManager, TransactionManager* transactionManager,
+                       ReservationManager* reservationManager, MemberManager* memberManager) :
+    memberManager(memberManager), bookManager(bookManager),
+    transactionManager(transactionManager), reservationManager(reservationManager), active(true) {
+    if (transactionManager) transactionManager->beginGroupCommit();
+    if (bookManager) bookManager->beginGroupCommit();
+    if (reservationManager) reservationManager->beginGroupCommit();
+    if (memberManager) memberManager->beginGroupCommit();
+}
+
+UnitOfWork::UnitOfWork(UnitOfWork&& other) noexcept :
+    memberManager(other.memberManager), bookManager(other.bookManager),
+    transactionManager(other.transactionManager), reservationManager(other.reservationManager),
+    active(other.active) {
+    other.active = false;
+}
+
+// 先落盘交易日志: 崩溃时交易记录是重建库存状态的依据
+// 每个管理器都要结束组提交, 前一个写入失败也不能让后面的管理器停留在暂存状态
+void UnitOfWork::commit() {
+    if (!active) {
+        return;
+    }
+    active = false;
+
+    std::string errors;
+    auto end = [&errors](std::function<void()> endGroup) {
+        try {
+            endGroup();
+        } catch (std::exception& e) {
+            errors += std::string(errors.empty() ? "" : "; ") + e.what();
+        }
+    };
+    if (transactionManager) end([this] { transactionManager->endGroupCommit(); });
+    if (bookManager) end([this] { bookManager->endGroupCommit(); });
+    if (reservationManager) end([this] { reservationManager->endGroupCommit(); });
+    if (memberManager) end([this] { memberManager->endGroupCommit(); });
+
+    if (!errors.empty()) {
+        throw std::runtime_error("Failed to commit unit of work: " + errors);
+    }
+}
+
+UnitOfWork::~UnitOfWork() {
+    try {
+        commit();
+    } catch (...) {
+        std::cerr << "在组提交过程中尝试保存数据时出错" << std::endl;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_UNITOFWORK_H
+#define LIBRARY_MANAGEMENT_SYSTEM_UNITOFWORK_H
+
+// 前向声明
+class MemberManager;
+class BookManager;
+class TransactionManager;
+class ReservationManager;
+
+// 跨管理器的组提交 (RAII)
+// 存活期间各管理器的变更只在内存中累积, 提交时每个数据文件只写出并同步一次;
+// 可嵌套, 内层提交不落盘, 由最外层统一提交, 因此批量借还时多次操作可合并为一次组提交
+// 不参与的管理器传 nullptr
+class UnitOfWork {
+private:
+    MemberManager* memberManager;
+    BookManager* bookManager;
+    TransactionManager* transactionManager;
+    ReservationManager* reservationManager;
+    bool active;
+
+public:
+    UnitOfWork(BookManager* bookManager, TransactionManager* transactionManager,
+               ReservationManager* reservationManager = nullptr, MemberManager* memberManager = nullptr);
+    ~UnitOfWork();
+
+    // 提交, 写入失败时抛出异常; 操作成功返回前必须调用, 使落盘失败能传给调用方
+    // 析构时若尚未提交则尽力提交, 只作为提前返回或异常展开时的兜底, 错误仅输出到 std::cerr
+    void commit();
+
+    UnitOfWork(UnitOfWork&&) noexcept;
+    UnitOfWork(const UnitOfWork&) = delete;
+    UnitOfWork& operator=(const UnitOfWork&) = delete;
+    UnitOfWork& operator=(UnitOfWork&&) = delete;
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_UNITOFWORK_H
@@ -1,23 +1,29 @@
 // Book.h 实现
 
 #include "Book.h"
+#include "../utils/CSVParser.h"
 #include <fstream>
 #include <iostream>
-#include <sstream>
 
-std::string Book::getISBN() const {
-    return isbn;
+const std::string& Book::getISBN() const {
+    return SymbolTable::getInstance().text(isbn);
 }
-std::string Book::getTitle() const {
+const std::string& Book::getTitle() const {
     return title;
 }
-std::string Book::getAuthor() const {
+const std::string& Book::getAuthor() const {
     return author;
 }
-std::string Book::getPublisher() const {
+const std::string& Book::getPublisher() const {
     return publisher;
 }
-std::string Book::getGenre() const {
+const std::string& Book::getGenre() const {
+    return SymbolTable::getInstance().text(genre);
+}
+Symbol Book::getISBNSymbol() const {
+    return isbn;
+}
+Symbol Book::getGenreSymbol() const {
     return genre;
 }
 int Book::getTotalCopies() const {
@@ -26,6 +32,9 @@ int Book::getTotalCopies() const {
 int Book::getAvailableCopies() const {
     return availableCopies;
 }
+bool Book::getIsReserved() const {
+    return isReserved;
+}
 bool Book::canBorrow() const {
     return !isReserved && availableCopies > 0;
 }
@@ -62,21 +71,22 @@ std::string Book::toCSV() const {
 }
 
 Book Book::fromCSV(const std::string& csvLine) {
-    Book book;
-    std::stringstream ss(csvLine);
-    getline(ss, book.isbn, ',');
-    getline(ss, book.title, ',');
-    getline(ss, book.author, ',');
-    getline(ss, book.publisher, ',');
-    getline(ss, book.genre, ',');
-    ss >> book.totalCopies;
-    ss.ignore(1);
-    ss >> book.availableCopies;
-    ss.ignore(1);
+    return fromCSV(csvLine.data(), csvLine.data() + csvLine.size());
+}
 
-    int boolInt;
-    ss >> boolInt;
-    book.isReserved = (boolInt != 0);
+Book Book::fromCSV(const char* begin, const char* end) {
+    CSVField fields[8];
+    CSVParser::splitLine(begin, end, fields, 8);
+
+    Book book;
+    book.isbn = fields[0].toSymbol();
+    book.title = fields[1].toString();
+    book.author = fields[2].toString();
+    book.publisher = fields[3].toString();
+    book.genre = fields[4].toSymbol();
+    book.totalCopies = fields[5].toInt();
+    book.availableCopies = fields[6].toInt();
+    book.isReserved = fields[7].toBool();
 
     return book;
 }
@@ -1,16 +1,17 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_BOOK_H
 #define LIBRARY_MANAGEMENT_SYSTEM_BOOK_H
 
+#include "../utils/SymbolTable.h"
 #include <string>
 #include <utility>
 
 class Book {
 private:
-    std::string isbn;                // ISBN 码, 键
+    Symbol isbn{};                   // ISBN 码, 键 (驻留句柄)
     std::string title;               // 书名
     std::string author;              // 作者
     std::string publisher;           // 出版社
-    std::string genre;               // 类别
+    Symbol genre{};                  // 类别 (驻留句柄)
 
     int totalCopies{};                // 图书总册数
     int availableCopies{};            // 图书有效册数
@@ -20,18 +21,21 @@ public:
     // 构造函数
     Book(std::string isbn, std::string title, std::string author, std::string publisher, std::string genre,
      int totalCopies = 0, int availableCopies = 0, bool isReserved = false)
-    : isbn(std::move(isbn)), title(std::move(title)), author(std::move(author)), publisher(std::move(publisher)),
-      genre(std::move(genre)), totalCopies(totalCopies), availableCopies(availableCopies), isReserved(isReserved) {}
+    : isbn(SymbolTable::getInstance().intern(isbn)), title(std::move(title)), author(std::move(author)),
+      publisher(std::move(publisher)), genre(SymbolTable::getInstance().intern(genre)), totalCopies(totalCopies), availableCopies(availableCopies), isReserved(isReserved) {}
     Book() = default;
 
     // 获取器和设置器
-    std::string getISBN() const;
-    std::string getTitle() const;
-    std::string getPublisher() const;
-    std::string getAuthor() const;
-    std::string getGenre() const;
+    const std::string& getISBN() const;
+    const std::string& getTitle() const;
+    const std::string& getPublisher() const;
+    const std::string& getAuthor() const;
+    const std::string& getGenre() const;
+    Symbol getISBNSymbol() const;
+    Symbol getGenreSymbol() const;
     int getTotalCopies() const;
     int getAvailableCopies() const;
+    bool getIsReserved() const;
     bool canBorrow() const;
 
     void borrowBook();
@@ -41,6 +45,7 @@ public:
     // CSV 函数
     std::string toCSV() const;
     static Book fromCSV(const std::string& csvLine);
+    static Book fromCSV(const char* begin, const char* end);      // 直接从行缓冲区解析, 不经过字符串流
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_BOOK_H
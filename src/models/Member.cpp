@@ -1,35 +1,47 @@
 // Member.h 实现
 
-#include <sstream>
+#include <algorithm>
 #include "Member.h"
+#include "../utils/CSVParser.h"
 #include "../utils/DateUtils.h"
 #include "../authentication/auth.h"
 
-std::string Member::getMemberID() const {
-    return memberID;
+const std::string& Member::getMemberID() const {
+    return SymbolTable::getInstance().text(memberID);
 }
-std::string Member::getName() const{
+const std::string& Member::getName() const {
     return name;
 }
-std::string Member::getPhoneNumber() const {
+const std::string& Member::getPhoneNumber() const {
     return phoneNumber;
 }
 std::vector<std::string> Member::getPreference() const {
+    const SymbolTable& symbols = SymbolTable::getInstance();
+    std::vector<std::string> texts;
+    texts.reserve(preference.size());
+    for (Symbol symbol : preference) {
+        texts.push_back(symbols.text(symbol));
+    }
+    return texts;
+}
+Symbol Member::getMemberSymbol() const {
+    return memberID;
+}
+const std::vector<Symbol>& Member::getPreferenceSymbols() const {
     return preference;
 }
-std::string Member::getRegistrationDate() const {
+Date Member::getRegistrationDate() const {
     return registrationDate;
 }
-std::string Member::getExpiryDate() const {
+Date Member::getExpiryDate() const {
     return expiryDate;
 }
-std::string Member::getPasswordHash() const {
+const std::string& Member::getPasswordHash() const {
     return passwordHash;
 }
+// 过期日当天零点起即视为过期 (与按时间戳比较的旧实现一致)
 bool Member::isExpired() const {
-    time_t nowTime = DateUtils::getCurrentTimestamp();
-    time_t expiryTime = DateUtils::dateToTimestamp(expiryDate);
-    return nowTime > expiryTime;
+    return DateUtils::today() >= expiryDate;
 }
 
 bool Member::getAdmin() const {
@@ -40,14 +52,25 @@ int Member::getMaxBooksAllowed() const {
     return maxBooksAllowed;
 }
 
+std::vector<Symbol> Member::internAll(const std::vector<std::string>& texts) {
+    SymbolTable& symbols = SymbolTable::getInstance();
+    std::vector<Symbol> result;
+    result.reserve(texts.size());
+    for (const auto& text : texts) {
+        result.push_back(symbols.intern(text));
+    }
+    return result;
+}
+
 bool Member::authenticate(const std::string& password) const {
     return auth::verifyPassword(password, passwordHash);
 }
 
 std::string Member::toCSV() const{
+    const SymbolTable& symbols = SymbolTable::getInstance();
     std::string preferenceList;
     for (size_t i = 0; i < preference.size(); ++i) {
-        preferenceList += preference[i];
+        preferenceList += symbols.text(preference[i]);
         if (i < preference.size() - 1) {
             preferenceList += ';';
         }
@@ -56,50 +79,49 @@ std::string Member::toCSV() const{
         preferenceList = "None";
     }
 
-    return memberID + "," +
+    return symbols.text(memberID) + "," +
            name + "," +
            phoneNumber + "," +
            preferenceList + "," +
-           registrationDate + "," +
-           expiryDate + "," +
+           registrationDate.toString() + "," +
+           expiryDate.toString() + "," +
            std::to_string(maxBooksAllowed) + "," +
            (isAdmin ? "1" : "0") + "," +
            passwordHash;
 }
 
 Member Member::fromCSV(const std::string& csvLine) {
-    Member member;
-    std::istringstream iss(csvLine);
+    return fromCSV(csvLine.data(), csvLine.data() + csvLine.size());
+}
 
-    getline(iss, member.memberID, ',');
-    getline(iss, member.name, ',');
-    getline(iss, member.phoneNumber, ',');
+Member Member::fromCSV(const char* begin, const char* end) {
+    CSVField fields[9];
+    CSVParser::splitLine(begin, end, fields, 9);
 
-    std::string preferenceList;
-    getline(iss, preferenceList, ',');
+    Member member;
+    member.memberID = fields[0].toSymbol();
+    member.name = fields[1].toString();
+    member.phoneNumber = fields[2].toString();
 
-    if (preferenceList != "None") {
-        std::istringstream prefStream(preferenceList);
-        std::string pref;
-        while (getline(prefStream, pref, ';')) {
-            if (!pref.empty()) {
-                member.preference.push_back(pref);
+    // 偏好以 ';' 分隔, "None" 表示无偏好
+    const CSVField& preferenceList = fields[3];
+    if (!preferenceList.equals("None")) {
+        const char* prefStart = preferenceList.data;
+        const char* prefEnd = preferenceList.data + preferenceList.size;
+        while (prefStart < prefEnd) {
+            const char* separator = std::find(prefStart, prefEnd, ';');
+            if (separator != prefStart) {
+                member.preference.push_back(SymbolTable::getInstance().intern(prefStart, separator - prefStart));
             }
+            prefStart = separator + 1;
         }
     }
 
-    getline(iss, member.registrationDate, ',');
-    getline(iss, member.expiryDate, ',');
-    iss.ignore(1);
-    iss >> member.maxBooksAllowed;
-    iss.ignore(1);
-
-    int boolInt;
-    iss >> boolInt;
-    member.isAdmin = (boolInt != 0);
-
-    iss.ignore(1);
-    getline(iss, member.passwordHash);
+    member.registrationDate = fields[4].toDate();
+    member.expiryDate = fields[5].toDate();
+    member.maxBooksAllowed = fields[6].toInt();
+    member.isAdmin = fields[7].toBool();
+    member.passwordHash = fields[8].toString();
 
     return member;
 }
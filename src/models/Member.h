@@ -3,41 +3,48 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_MEMBER_H
 #define LIBRARY_MANAGEMENT_SYSTEM_MEMBER_H
 
+#include "../utils/Date.h"
+#include "../utils/SymbolTable.h"
 #include <string>
 #include <vector>
 #include <utility>
 
 class Member {
 private:
-    std::string memberID;                       // 会员 ID
+    Symbol memberID{};                          // 会员 ID (驻留句柄)
     std::string name;                           // 会员姓名
     std::string phoneNumber;                    // 会员手机号码
-    std::vector<std::string> preference;        // 会员偏好类别
-    std::string registrationDate;               // 会员注册日 (YYYY-MM-DD)
-    std::string expiryDate;                     // 会员过期日 (YYYY-MM-DD)
+    std::vector<Symbol> preference;             // 会员偏好类别 (驻留句柄)
+    Date registrationDate;                      // 会员注册日
+    Date expiryDate;                            // 会员过期日
     int maxBooksAllowed{};                      // 会员最多可借阅的书籍数量(默认 2 本)
     bool isAdmin{};                             // true = 管理员, false = 会员
     std::string passwordHash;                   // 用于验证
 
+    // 助手: 逐个驻留偏好类别
+    static std::vector<Symbol> internAll(const std::vector<std::string>& texts);
+
 public:
     // 构造函数
     Member(std::string memberID, std::string name, std::string phoneNumber,
-        std::vector<std::string> preference, std::string registrationDate, std::string expiryDate,
+        std::vector<std::string> preference, Date registrationDate, Date expiryDate,
         int maxBooksAllowed = 2, bool isAdmin = false, std::string passwordHash = ""):
-        memberID(std::move(memberID)), name(std::move(name)), phoneNumber(std::move(phoneNumber)),
-        preference(std::move(preference)), registrationDate(std::move(registrationDate)),
-        expiryDate(std::move(expiryDate)), maxBooksAllowed(maxBooksAllowed),
+        memberID(SymbolTable::getInstance().intern(memberID)), name(std::move(name)),
+        phoneNumber(std::move(phoneNumber)), preference(internAll(preference)), registrationDate(registrationDate),
+        expiryDate(expiryDate), maxBooksAllowed(maxBooksAllowed),
         isAdmin(isAdmin), passwordHash(std::move(passwordHash)) {}
     Member() = default;
 
     // 获取器和设置器
-    std::string getMemberID() const;
-    std::string getName() const;
-    std::string getPhoneNumber() const;
-    std::vector<std::string> getPreference() const;
-    std::string getRegistrationDate() const;
-    std::string getExpiryDate() const;
-    std::string getPasswordHash() const;
+    const std::string& getMemberID() const;
+    const std::string& getName() const;
+    const std::string& getPhoneNumber() const;
+    std::vector<std::string> getPreference() const;             // 新建字符串列表, 供界面和 CSV 使用
+    Symbol getMemberSymbol() const;
+    const std::vector<Symbol>& getPreferenceSymbols() const;
+    Date getRegistrationDate() const;
+    Date getExpiryDate() const;
+    const std::string& getPasswordHash() const;
     bool isExpired() const;
     bool getAdmin() const;
     int getMaxBooksAllowed() const;
@@ -46,6 +53,7 @@ public:
     // CSV 函数
     std::string toCSV() const;
     static Member fromCSV(const std::string& csvLine);
+    static Member fromCSV(const char* begin, const char* end);        // 直接从行缓冲区解析, 不经过字符串流
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_MEMBER_H
@@ -1,18 +1,24 @@
 // Reservation.h 实现
 
 #include "Reservation.h"
-#include <sstream>
+#include "../utils/CSVParser.h"
 
-std::string Reservation::getReservationID() const {
+const std::string& Reservation::getReservationID() const {
     return reservationID;
 }
-std::string Reservation::getMemberID() const {
+const std::string& Reservation::getMemberID() const {
+    return SymbolTable::getInstance().text(memberID);
+}
+const std::string& Reservation::getISBN() const {
+    return SymbolTable::getInstance().text(isbn);
+}
+Symbol Reservation::getMemberSymbol() const {
     return memberID;
 }
-std::string Reservation::getISBN() const {
+Symbol Reservation::getISBNSymbol() const {
     return isbn;
 }
-std::string Reservation::getReservationDate() const {
+Date Reservation::getReservationDate() const {
     return reservationDate;
 }
 bool Reservation::getIsActive() const {
@@ -25,25 +31,28 @@ void Reservation::cancelReservation() {
 }
 
 std::string Reservation::toCSV() const {
+    const SymbolTable& symbols = SymbolTable::getInstance();
     return reservationID + "," +
-    memberID + "," +
-    isbn + "," +
-    reservationDate + "," +
+    symbols.text(memberID) + "," +
+    symbols.text(isbn) + "," +
+    reservationDate.toString() + "," +
     (isActive ? "1" : "0");
 }
 
 Reservation Reservation::fromCSV(const std::string &csvLine) {
-    Reservation reservation;
-    std::istringstream iss(csvLine);
+    return fromCSV(csvLine.data(), csvLine.data() + csvLine.size());
+}
 
-    std::getline(iss, reservation.reservationID, ',');
-    std::getline(iss, reservation.memberID, ',');
-    std::getline(iss, reservation.isbn, ',');
-    std::getline(iss, reservation.reservationDate, ',');
+Reservation Reservation::fromCSV(const char* begin, const char* end) {
+    CSVField fields[5];
+    CSVParser::splitLine(begin, end, fields, 5);
 
-    int boolInt;
-    iss >> boolInt;
-    reservation.isActive = (boolInt != 0);
+    Reservation reservation;
+    reservation.reservationID = fields[0].toString();
+    reservation.memberID = fields[1].toSymbol();
+    reservation.isbn = fields[2].toSymbol();
+    reservation.reservationDate = fields[3].toDate();
+    reservation.isActive = fields[4].toBool();
 
     return reservation;
 }
@@ -1,30 +1,35 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_RESERVATION_H
 #define LIBRARY_MANAGEMENT_SYSTEM_RESERVATION_H
 
+#include "../utils/Date.h"
+#include "../utils/SymbolTable.h"
 #include <string>
 
 class Reservation {
 private:
     std::string reservationID;          // 预约 ID
-    std::string memberID;               // 预约者 ID
-    std::string isbn;                   // 被预约书 ISBN
-    std::string reservationDate;        // 预约日期
+    Symbol memberID{};                  // 预约者 ID (驻留句柄)
+    Symbol isbn{};                      // 被预约书 ISBN (驻留句柄)
+    Date reservationDate;               // 预约日期
     bool isActive{};                    // 预约有效标记
 
 public:
     // 构造函数
     Reservation(std::string reservationID, std::string memberID, std::string isbn,
-                std::string reservationDate, bool isActive = true) :
-                reservationID(std::move(reservationID)), memberID(std::move(memberID)),
-                isbn(std::move(isbn)), reservationDate(std::move(reservationDate)),
+                Date reservationDate, bool isActive = true) :
+                reservationID(std::move(reservationID)),
+                memberID(SymbolTable::getInstance().intern(memberID)),
+                isbn(SymbolTable::getInstance().intern(isbn)), reservationDate(reservationDate),
                 isActive(isActive){}
     Reservation() = default;
 
     // 获取器和设置器
-    std::string getReservationID() const;
-    std::string getMemberID() const;
-    std::string getISBN() const;
-    std::string getReservationDate() const;
+    const std::string& getReservationID() const;
+    const std::string& getMemberID() const;
+    const std::string& getISBN() const;
+    Symbol getMemberSymbol() const;
+    Symbol getISBNSymbol() const;
+    Date getReservationDate() const;
     bool getIsActive() const;
 
     // 业务逻辑
@@ -33,6 +38,7 @@ public:
     // 实用方法
     std::string toCSV() const;
     static Reservation fromCSV(const std::string& csvLine);
+    static Reservation fromCSV(const char* begin, const char* end);   // 直接从行缓冲区解析, 不经过字符串流
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_RESERVATION_H
@@ -1,28 +1,33 @@
 // Transaction.h 实现
 
 #include "Transaction.h"
+#include "../utils/CSVParser.h"
 #include "../utils/DateUtils.h"
-#include <ctime>
 #include <iostream>
-#include <sstream>
 #include <string>
 
-std::string Transaction::getTransactionID() const {
+const std::string& Transaction::getTransactionID() const {
     return transactionID;
 }
-std::string Transaction::getUserID() const {
+const std::string& Transaction::getUserID() const {
+    return SymbolTable::getInstance().text(userID);
+}
+const std::string& Transaction::getISBN() const {
+    return SymbolTable::getInstance().text(isbn);
+}
+Symbol Transaction::getUserSymbol() const {
     return userID;
 }
-std::string Transaction::getISBN() const {
+Symbol Transaction::getISBNSymbol() const {
     return isbn;
 }
-std::string Transaction::getBorrowDate() const {
+Date Transaction::getBorrowDate() const {
     return borrowDate;
 }
-std::string Transaction::getDueDate() const {
+Date Transaction::getDueDate() const {
     return dueDate;
 }
-std::string Transaction::getReturnDate() const {
+Date Transaction::getReturnDate() const {
     return returnDate;
 }
 int Transaction::getRenewCount() const {
@@ -36,17 +41,25 @@ bool Transaction::haveReturned() const {
 }
 
 bool Transaction::isOverdue() const {
-    time_t currentDateTimestamp = std::time(nullptr);
-    time_t dueDateTimestamp = DateUtils::dateToTimestamp(dueDate);
-    return currentDateTimestamp > dueDateTimestamp;
+    return isOverdue(DateUtils::today());
+}
+
+// 到期日当天零点起即视为逾期 (与按时间戳比较的旧实现一致)
+// 空到期日早于任何日期, 总视为逾期, 与旧实现把它当作 1970-01-01 的结果相同
+bool Transaction::isOverdue(Date today) const {
+    return today >= dueDate;
 }
 
 double Transaction::calculateFine() const {
-    if (!Transaction::isOverdue()) {
+    return calculateFine(DateUtils::today());
+}
+
+double Transaction::calculateFine(Date today) const {
+    if (!isOverdue(today)) {
         return 0.0;
     }
-    unsigned int increment = DateUtils::daysBetween(DateUtils::dateToTimestamp(dueDate),
-                                                    DateUtils::getCurrentTimestamp());
+    // 空到期日 (缺失或无法解析) 按 1970-01-01 计, 与旧实现一致: 视为逾期, 罚款取上限
+    int increment = (dueDate.empty() ? Date(0) : dueDate).daysUntil(today);
 
     double amount = increment * 2.0;
     if (amount > 14.0) amount = 14.0;
@@ -55,22 +68,22 @@ double Transaction::calculateFine() const {
 
 bool Transaction::canRenew() const {
     if (isReturned) return false;
-    unsigned int totalDays = DateUtils::daysBetween(DateUtils::dateToTimestamp(borrowDate),
-                                                     DateUtils::dateToTimestamp(dueDate));
+    if (borrowDate.empty() || dueDate.empty()) return false;     // 日期缺失时无法确定已借天数
+    int totalDays = borrowDate.daysUntil(dueDate);
 
-    return  (totalDays + 7 <= 30);
+    return  (totalDays >= 0 && totalDays + 7 <= 30);
 }
 
 void Transaction::renewBook() {
     if (!canRenew()) return;
-    dueDate = DateUtils::addDays(dueDate, 7);
+    dueDate = dueDate.addDays(7);
     renewCount++;
 }
 
 void Transaction::returnBook() {
     if (isReturned) return;
     fine = calculateFine();
-    returnDate = DateUtils::getCurrentDate();
+    returnDate = DateUtils::today();
     isReturned = true;
     if (fine > 0) {
         std::cout << "您已逾期! 请支付罚款: $" << fine << std::endl;
@@ -78,36 +91,36 @@ void Transaction::returnBook() {
 }
 
 std::string Transaction::toCSV() const {
+    const SymbolTable& symbols = SymbolTable::getInstance();
     return transactionID + "," +
-           userID + "," +
-           isbn + "," +
-           borrowDate + "," +
-           dueDate + "," +
-           returnDate + "," +
+           symbols.text(userID) + "," +
+           symbols.text(isbn) + "," +
+           borrowDate.toString() + "," +
+           dueDate.toString() + "," +
+           returnDate.toString() + "," +
            std::to_string(renewCount) + "," +
            std::to_string(fine) + "," +
            (isReturned ? "1" : "0");
 }
 
 Transaction Transaction::fromCSV(const std::string& csvLine) {
+    return fromCSV(csvLine.data(), csvLine.data() + csvLine.size());
+}
+
+Transaction Transaction::fromCSV(const char* begin, const char* end) {
+    CSVField fields[9];
+    CSVParser::splitLine(begin, end, fields, 9);
+
     Transaction transaction;
-    std::istringstream iss(csvLine);
-
-    std::getline(iss, transaction.transactionID, ',');
-    std::getline(iss, transaction.userID, ',');
-    std::getline(iss, transaction.isbn, ',');
-    std::getline(iss, transaction.borrowDate, ',');
-    std::getline(iss, transaction.dueDate, ',');
-    std::getline(iss, transaction.returnDate, ',');
-
-    iss >> transaction.renewCount;
-    iss.ignore(1);
-    iss >> transaction.fine;
-    iss.ignore(1);
-
-    int boolInt;
-    iss >> boolInt;
-    transaction.isReturned = (boolInt != 0);
+    transaction.transactionID = fields[0].toString();
+    transaction.userID = fields[1].toSymbol();
+    transaction.isbn = fields[2].toSymbol();
+    transaction.borrowDate = fields[3].toDate();
+    transaction.dueDate = fields[4].toDate();
+    transaction.returnDate = fields[5].toDate();
+    transaction.renewCount = fields[6].toInt();
+    transaction.fine = fields[7].toDouble();
+    transaction.isReturned = fields[8].toBool();
 
     return transaction;
 }
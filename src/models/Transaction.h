@@ -1,16 +1,18 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_TRANSACTION_H
 #define LIBRARY_MANAGEMENT_SYSTEM_TRANSACTION_H
 
+#include "../utils/Date.h"
+#include "../utils/SymbolTable.h"
 #include <string>
 
 class Transaction {
 private:
     std::string transactionID;      // 交易 ID
-    std::string userID;             // 用户 ID
-    std::string isbn;               // 书目 ISBN
-    std::string borrowDate;         // 借阅日期 (YYYY-MM-DD)
-    std::string dueDate;            // 逾期日期 (YYYY-MM-DD)
-    std::string returnDate;         // 归还日期 (YYYY-MM-DD)
+    Symbol userID{};                // 用户 ID (驻留句柄)
+    Symbol isbn{};                  // 书目 ISBN (驻留句柄)
+    Date borrowDate;                // 借阅日期
+    Date dueDate;                   // 逾期日期
+    Date returnDate;                // 归还日期 (未归还时为空)
     int renewCount{};               // 续约次数
     double fine{};                  // 罚款金额
     bool isReturned{};              // true = 已归还, false = 未归还
@@ -18,21 +20,24 @@ private:
 public:
     // 构造函数
     Transaction(std::string transactionID, std::string userID, std::string isbn,
-                std::string borrowDate, std::string dueDate, std::string returnDate,
+                Date borrowDate, Date dueDate, Date returnDate,
                 int renewCount = 0, double fine = 0.0, bool isReturned = false):
-                transactionID(std::move(transactionID)), userID(std::move(userID)),
-                isbn(std::move(isbn)), borrowDate(std::move(borrowDate)),
-                dueDate(std::move(dueDate)), returnDate(std::move(returnDate)),
+                transactionID(std::move(transactionID)),
+                userID(SymbolTable::getInstance().intern(userID)),
+                isbn(SymbolTable::getInstance().intern(isbn)), borrowDate(borrowDate),
+                dueDate(dueDate), returnDate(returnDate),
                 renewCount(renewCount), fine(fine), isReturned(isReturned){}
     Transaction() = default;
 
     // 获取器和设置器
-    std::string getTransactionID() const;
-    std::string getUserID() const;
-    std::string getISBN() const;
-    std::string getBorrowDate() const;
-    std::string getDueDate() const;
-    std::string getReturnDate() const;
+    const std::string& getTransactionID() const;
+    const std::string& getUserID() const;
+    const std::string& getISBN() const;
+    Symbol getUserSymbol() const;       // 索引和批量比较用句柄, 不经过字符串
+    Symbol getISBNSymbol() const;
+    Date getBorrowDate() const;
+    Date getDueDate() const;
+    Date getReturnDate() const;
     int getRenewCount() const;
     double getFine() const;
     bool haveReturned() const;
@@ -40,6 +45,9 @@ public:
     // 业务逻辑
     bool isOverdue() const;
     double calculateFine() const;
+    // 批量检查时由调用者取一次今天的日期传入
+    bool isOverdue(Date today) const;
+    double calculateFine(Date today) const;
     bool canRenew() const;
     void renewBook();
     void returnBook();
@@ -47,6 +55,7 @@ public:
     // 实用方法
     std::string toCSV() const;
     static Transaction fromCSV(const std::string& csvLine);
+    static Transaction fromCSV(const char* begin, const char* end);   // 直接从行缓冲区解析, 不经过字符串流
 };
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_TRANSACTION_H
@@ -216,15 +216,19 @@ void MenuHandler::handleSearchBooks() {
     std::cout << "  3. ISBN\n";
     std::cout << "  4. 类型\n";
     std::cout << "  5. 出版社\n";
+    std::cout << "  6. 模糊搜索 (书名/作者, 容许错别字)\n";
+    std::cout << "  7. 组合搜索 (多个条件同时满足)\n";
     std::cout << "  0. 回退\n\n";
 
-    int choice = promptForInt("请输入你的选择: ", 0, 5);
+    int choice = promptForInt("请输入你的选择: ", 0, 7);
     switch (choice) {
         case 1: performBookSearch("title"); break;
         case 2: performBookSearch("author"); break;
         case 3: performBookSearch("isbn"); break;
         case 4: performBookSearch("genre"); break;
         case 5: performBookSearch("publisher"); break;
+        case 6: performBookSearch("fuzzy"); break;
+        case 7: performCombinedBookSearch(); break;
         case 0: return;
         default: {
             displayMessage("无效选择", "error");
@@ -402,7 +406,7 @@ void MenuHandler::handleReserveBook() {
         return;
     }
 
-    std::string reservationID = reservationManager.reserveBook(currentUser->getMemberID(), isbn);
+    std::string reservationID = reservationManager.reserveBook(memberManager, bookManager, currentUser->getMemberID(), isbn);
 
     if (reservationID == "0") {
         displayMessage("预订图书失败, 请重试或联系管理员", "error");
@@ -448,10 +452,11 @@ void MenuHandler::handleViewBorrowedBooks() {
     std::cout << std::string(100, '=') << "\n";
 
     double totalFine = 0.0;
+    const Date today = DateUtils::today();
     for (const auto& transaction : borrowedBooks) {
         Book* book = bookManager.findBookByISBN(transaction->getISBN());
         if (book) {
-            double fine = transaction->calculateFine();
+            double fine = transaction->calculateFine(today);
             totalFine += fine;
 
             std::cout << std::left << std::setw(15) << transaction->getISBN()
@@ -497,7 +502,7 @@ void MenuHandler::handleViewBorrowingHistory() {
         std::cout << std::left << std::setw(15) << transaction->getISBN()
                   << std::setw(30) << title
                   << std::setw(15) << transaction->getBorrowDate()
-                  << std::setw(15) << (transaction->getReturnDate().empty() ? "N/A" : transaction->getReturnDate())
+                  << std::setw(15) << (transaction->getReturnDate().empty() ? "N/A" : transaction->getReturnDate().toString())
                   << std::setw(10) << (transaction->haveReturned() ? "已归还" : "活跃")
                   << std::setw(10) << std::fixed << std::setprecision(2) << transaction->getFine() << "\n";
     }
@@ -599,7 +604,7 @@ void MenuHandler::handleViewReservations() {
         if (confirmAction("您想要取消预约吗?")) {
             std::string reservationID = promptForInput("输入预订ID以取消: ");
             if (!reservationID.empty()) {
-                std::string result = reservationManager.cancelReservation(reservationID);
+                std::string result = reservationManager.cancelReservation(bookManager, reservationID);
                 if (result != "0") {
                     displayMessage("预订已成功取消! 其他人的排队位置已更新", "success");
                 } else {
@@ -859,13 +864,14 @@ void MenuHandler::handleViewOverdueBooks() {
     std::cout << std::string(120, '=') << "\n";
 
     double totalFines = 0.0;
+    const Date today = DateUtils::today();
     for (const auto& transaction : overdueTransactions) {
         Member* member = memberManager.findMemberByID(transaction->getUserID());
         Book* book = bookManager.findBookByISBN(transaction->getISBN());
 
         std::string memberName = member ? member->getName().substr(0, 18) : "未知";
         std::string bookTitle = book ? book->getTitle().substr(0, 28) : "未知";
-        double fine = transaction->calculateFine();
+        double fine = transaction->calculateFine(today);
         totalFines += fine;
 
         std::cout << std::left << std::setw(12) << transaction->getUserID()
@@ -1089,42 +1095,43 @@ void MenuHandler::handleDeleteBook() {
 }
 
 void MenuHandler::handleViewAllBooks() {
-    clearScreen();
-    ui.displayHeader("馆藏所有图书");
-
     // 如果用户在程序外手动修改了 CSV
     bookManager.clearCache();
     bookManager.reload();
-    auto allBooks = bookManager.getAllBooks();
-
-    if (allBooks.empty()) {
-        displayMessage("馆藏无书", "info");
-        pauseScreen();
-        return;
-    }
 
-    std::cout << "\n" << std::string(120, '=') << "\n";
-    std::cout << std::left << std::setw(15) << "ISBN"
-              << std::setw(35) << "Title"
-              << std::setw(25) << "Author"
-              << std::setw(20) << "Genre"
-              << std::setw(10) << "Total"
-              << std::setw(10) << "Available" << "\n";
-    std::cout << std::string(120, '=') << "\n";
+    size_t offset = 0;
+    do {
+        clearScreen();
+        ui.displayHeader("馆藏所有图书");
 
-    for (const auto& book : allBooks) {
-        std::cout << std::left << std::setw(15) << book.getISBN()
-                  << std::setw(35) << book.getTitle().substr(0, 33)
-                  << std::setw(25) << book.getAuthor().substr(0, 23)
-                  << std::setw(20) << book.getGenre().substr(0, 18)
-                  << std::setw(10) << book.getTotalCopies()
-                  << std::setw(10) << book.getAvailableCopies() << "\n";
-    }
-    std::cout << std::string(120, '=') << "\n";
-    std::cout << "图书总数: " << allBooks.size() << "\n";
-    std::cout << std::string(120, '=') << "\n";
+        auto page = bookManager.getBooksPage(offset, Config::PAGE_SIZE);
+        if (page.total == 0) {
+            displayMessage("馆藏无书", "info");
+            pauseScreen();
+            return;
+        }
 
-    pauseScreen();
+        std::cout << "\n" << std::string(120, '=') << "\n";
+        std::cout << std::left << std::setw(15) << "ISBN"
+                  << std::setw(35) << "Title"
+                  << std::setw(25) << "Author"
+                  << std::setw(20) << "Genre"
+                  << std::setw(10) << "Total"
+                  << std::setw(10) << "Available" << "\n";
+        std::cout << std::string(120, '=') << "\n";
+
+        for (const Book* book : page.items) {
+            std::cout << std::left << std::setw(15) << book->getISBN()
+                      << std::setw(35) << book->getTitle().substr(0, 33)
+                      << std::setw(25) << book->getAuthor().substr(0, 23)
+                      << std::setw(20) << book->getGenre().substr(0, 18)
+                      << std::setw(10) << book->getTotalCopies()
+                      << std::setw(10) << book->getAvailableCopies() << "\n";
+        }
+        std::cout << std::string(120, '=') << "\n";
+        std::cout << "图书总数: " << page.total << "\n";
+        std::cout << std::string(120, '=') << "\n";
+    } while (promptPageNavigation(offset, static_cast<size_t>(bookManager.getTotalBooks())));
 }
 
 void MenuHandler::handleAddMember() {
@@ -1211,8 +1218,8 @@ void MenuHandler::handleAddMember() {
     std::string memberID = generateNextMemberID(isAdmin);
 
     // 生成数据
-    std::string registrationDate = DateUtils::getCurrentDate();
-    std::string expiryDate = DateUtils::addDays(registrationDate, 365); // 1 year membership
+    Date registrationDate = DateUtils::today();
+    Date expiryDate = registrationDate.addDays(365); // 1 year membership
 
     // 对密码进行哈希处理
     std::string passwordHash = auth::hashPassword(password);
@@ -1347,77 +1354,77 @@ void MenuHandler::handleDeleteMember() {
 }
 
 void MenuHandler::handleViewAllMembers() {
-    clearScreen();
-    ui.displayHeader("所有会员");
-
-    auto allMembers = memberManager.getAllMembers();
-
-    if (allMembers.empty()) {
-        displayMessage("查无会员", "info");
-        pauseScreen();
-        return;
-    }
-
-    std::cout << "\n" << std::string(100, '=') << "\n";
-    std::cout << std::left << std::setw(12) << "会员 ID"
-              << std::setw(25) << "姓名"
-              << std::setw(15) << "手机号码"
-              << std::setw(10) << "类型"
-              << std::setw(8) << "状态" << "\n";
-    std::cout << std::string(100, '=') << "\n";
+    size_t offset = 0;
+    do {
+        clearScreen();
+        ui.displayHeader("所有会员");
 
-    for (const auto& member : allMembers) {
-        std::cout << std::left << std::setw(12) << member.getMemberID()
-                  << std::setw(25) << member.getName().substr(0, 23)
-                  << std::setw(15) << member.getPhoneNumber()
-                  << std::setw(10) << (member.getAdmin() ? "管理员" : "会员")
-                  << std::setw(8) << (member.isExpired() ? "已过期" : "有效") << "\n";
-    }
-    std::cout << std::string(100, '=') << "\n";
-    std::cout << "会员总数: " << allMembers.size() << "\n";
-    std::cout << std::string(100, '=') << "\n";
+        auto page = memberManager.getMembersPage(offset, Config::PAGE_SIZE);
+        if (page.total == 0) {
+            displayMessage("查无会员", "info");
+            pauseScreen();
+            return;
+        }
 
-    pauseScreen();
+        std::cout << "\n" << std::string(100, '=') << "\n";
+        std::cout << std::left << std::setw(12) << "会员 ID"
+                  << std::setw(25) << "姓名"
+                  << std::setw(15) << "手机号码"
+                  << std::setw(10) << "类型"
+                  << std::setw(8) << "状态" << "\n";
+        std::cout << std::string(100, '=') << "\n";
+
+        for (const Member* member : page.items) {
+            std::cout << std::left << std::setw(12) << member->getMemberID()
+                      << std::setw(25) << member->getName().substr(0, 23)
+                      << std::setw(15) << member->getPhoneNumber()
+                      << std::setw(10) << (member->getAdmin() ? "管理员" : "会员")
+                      << std::setw(8) << (member->isExpired() ? "已过期" : "有效") << "\n";
+        }
+        std::cout << std::string(100, '=') << "\n";
+        std::cout << "会员总数: " << page.total << "\n";
+        std::cout << std::string(100, '=') << "\n";
+    } while (promptPageNavigation(offset, static_cast<size_t>(memberManager.getTotalMembers())));
 }
 
 void MenuHandler::handleViewAllTransactions() {
-    clearScreen();
-    ui.displayHeader("所有交易");
-
-    auto allTransactions = transactionManager.getAllTransactions();
-
-    if (allTransactions.empty()) {
-        displayMessage("查无交易", "info");
-        pauseScreen();
-        return;
-    }
-
-    std::cout << "\n" << std::string(120, '=') << "\n";
-    std::cout << std::left << std::setw(15) << "交易 ID"
-              << std::setw(12) << "会员 ID"
-              << std::setw(15) << "ISBN"
-              << std::setw(15) << "借阅日期"
-              << std::setw(15) << "应还日期"
-              << std::setw(15) << "归还日期"
-              << std::setw(10) << "状态"
-              << std::setw(8) << "罚款" << "\n";
-    std::cout << std::string(120, '=') << "\n";
+    size_t offset = 0;
+    do {
+        clearScreen();
+        ui.displayHeader("所有交易");
 
-    for (const auto& transaction : allTransactions) {
-        std::cout << std::left << std::setw(15) << transaction.getTransactionID()
-                  << std::setw(12) << transaction.getUserID()
-                  << std::setw(15) << transaction.getISBN()
-                  << std::setw(15) << transaction.getBorrowDate()
-                  << std::setw(15) << transaction.getDueDate()
-                  << std::setw(15) << (transaction.getReturnDate().empty() ? "N/A" : transaction.getReturnDate())
-                  << std::setw(10) << (transaction.haveReturned() ? "已归还" : "活跃")
-                  << "$" << std::setw(7) << std::fixed << std::setprecision(2) << transaction.getFine() << "\n";
-    }
-    std::cout << std::string(120, '=') << "\n";
-    std::cout << "交易总数: " << allTransactions.size() << "\n";
-    std::cout << std::string(120, '=') << "\n";
+        auto page = transactionManager.getTransactionsPage(offset, Config::PAGE_SIZE);
+        if (page.total == 0) {
+            displayMessage("查无交易", "info");
+            pauseScreen();
+            return;
+        }
 
-    pauseScreen();
+        std::cout << "\n" << std::string(120, '=') << "\n";
+        std::cout << std::left << std::setw(15) << "交易 ID"
+                  << std::setw(12) << "会员 ID"
+                  << std::setw(15) << "ISBN"
+                  << std::setw(15) << "借阅日期"
+                  << std::setw(15) << "应还日期"
+                  << std::setw(15) << "归还日期"
+                  << std::setw(10) << "状态"
+                  << std::setw(8) << "罚款" << "\n";
+        std::cout << std::string(120, '=') << "\n";
+
+        for (const Transaction* transaction : page.items) {
+            std::cout << std::left << std::setw(15) << transaction->getTransactionID()
+                      << std::setw(12) << transaction->getUserID()
+                      << std::setw(15) << transaction->getISBN()
+                      << std::setw(15) << transaction->getBorrowDate()
+                      << std::setw(15) << transaction->getDueDate()
+                      << std::setw(15) << (transaction->getReturnDate().empty() ? "N/A" : transaction->getReturnDate().toString())
+                      << std::setw(10) << (transaction->haveReturned() ? "已归还" : "活跃")
+                      << "$" << std::setw(7) << std::fixed << std::setprecision(2) << transaction->getFine() << "\n";
+        }
+        std::cout << std::string(120, '=') << "\n";
+        std::cout << "交易总数: " << page.total << "\n";
+        std::cout << std::string(120, '=') << "\n";
+    } while (promptPageNavigation(offset, static_cast<size_t>(transactionManager.getTotalTransactions())));
 }
 
 void MenuHandler::handleViewActiveTransactions() {
@@ -1441,6 +1448,7 @@ void MenuHandler::handleViewActiveTransactions() {
               << std::setw(8) << "罚款" << "\n";
     std::cout << std::string(110, '=') << "\n";
 
+    const Date today = DateUtils::today();
     for (const auto& transaction : activeTransactions) {
         Member* memberByTransaction = memberManager.findMemberByID(transaction->getUserID());
         Book* book = bookManager.findBookByISBN(transaction->getISBN());
@@ -1454,7 +1462,7 @@ void MenuHandler::handleViewActiveTransactions() {
                   << std::setw(30) << bookTitle
                   << std::setw(15) << transaction->getBorrowDate()
                   << std::setw(15) << transaction->getDueDate()
-                  << "$" << std::setw(7) << std::fixed << std::setprecision(2) << transaction->calculateFine() << "\n";
+                  << "$" << std::setw(7) << std::fixed << std::setprecision(2) << transaction->calculateFine(today) << "\n";
     }
     std::cout << std::string(110, '=') << "\n";
     std::cout << "活跃交易总数: " << activeTransactions.size() << "\n";
@@ -1474,7 +1482,7 @@ void MenuHandler::handleManualReturn() {
     if (isbn.empty()) return;
 
     if (confirmAction("开始为 " + memberID + " 归还图书 " + isbn + "?")) {
-        if (transactionManager.returnBook(memberID, isbn)) {
+        if (transactionManager.returnBook(bookManager, memberID, isbn)) {
             displayMessage("图书归还成功", "success");
         } else {
             displayMessage("处理还书失败, 请核实详情", "error");
@@ -1491,14 +1499,14 @@ void MenuHandler::handleGenerateInventoryReport() {
     std::cout << "\n生成库存报告中...\n\n";
 
     ReportManager reportManager(
-        Config::BOOKS_FILE,
-        Config::MEMBERS_FILE,
-        Config::TRANSACTIONS_FILE,
-        Config::RESERVATIONS_FILE,
+        bookManager,
+        memberManager,
+        transactionManager,
+        reservationManager,
         Config::REPORTS_DIR
     );
 
-    if (reportManager.generateInventoryReport(true)) {
+    if (reportManager.generateInventoryReport()) {
         displayMessage("库存报告生成成功!", "success");
         std::cout << "\n✓ 报告保存至: " << Config::REPORTS_DIR << "\n";
         std::cout << "  检查报表目录以获取详细的库存报告\n";
@@ -1516,14 +1524,14 @@ void MenuHandler::handleGenerateMemberReport() {
     std::cout << "\n生成会员报告...\n\n";
 
     ReportManager reportManager(
-        Config::BOOKS_FILE,
-        Config::MEMBERS_FILE,
-        Config::TRANSACTIONS_FILE,
-        Config::RESERVATIONS_FILE,
+        bookManager,
+        memberManager,
+        transactionManager,
+        reservationManager,
         Config::REPORTS_DIR
     );
 
-    if (reportManager.generateMemberReport(true)) {
+    if (reportManager.generateMemberReport()) {
         displayMessage("会员报告生成成功!", "success");
         std::cout << "\n✓ 报告保存至: " << Config::REPORTS_DIR << "\n";
         std::cout << "  检查报表目录以获取详细的库存报告\n";
@@ -1546,14 +1554,14 @@ void MenuHandler::handleGenerateTransactionReport() {
     std::cout << "\n生成最新的 " << topN << " 个交易中...\n\n";
 
     ReportManager reportManager(
-        Config::BOOKS_FILE,
-        Config::MEMBERS_FILE,
-        Config::TRANSACTIONS_FILE,
-        Config::RESERVATIONS_FILE,
+        bookManager,
+        memberManager,
+        transactionManager,
+        reservationManager,
         Config::REPORTS_DIR
     );
 
-    if (reportManager.generateTransactionReport(topN, true)) {
+    if (reportManager.generateTransactionReport(topN)) {
         displayMessage("交易报告生成成功!", "success");
         std::cout << "\n✓ 报告保存至: " << Config::REPORTS_DIR << "\n";
         std::cout << "  包含了最新的 " << topN << " 个交易\n";
@@ -1579,14 +1587,14 @@ void MenuHandler::handleGenerateStatisticsReport() {
     std::cout << "\n生成所有报告中...\n\n";
 
     ReportManager reportManager(
-        Config::BOOKS_FILE,
-        Config::MEMBERS_FILE,
-        Config::TRANSACTIONS_FILE,
-        Config::RESERVATIONS_FILE,
+        bookManager,
+        memberManager,
+        transactionManager,
+        reservationManager,
         Config::REPORTS_DIR
     );
 
-    if (reportManager.generateAllReports(topN, true)) {
+    if (reportManager.generateAllReports(topN)) {
         displayMessage("所有统计报告生成成功!", "success");
         std::cout << "\n✓ 报告保存至: " << Config::REPORTS_DIR << "\n";
         std::cout << "\n生成的报告:\n";
@@ -1881,53 +1889,50 @@ void MenuHandler::handleManageReservations() {
 }
 
 void MenuHandler::handleViewAllReservation() {
-    clearScreen();
-    ui.displayHeader("所有预订");
-
-    const auto& allReservations = reservationManager.getAllReservations();
-
-    if (allReservations.empty()) {
-        displayMessage("未找到预订", "info");
-        pauseScreen();
-        return;
-    }
-
-    std::cout << "\n" << std::string(120, '=') << "\n";
-    std::cout << std::left << std::setw(15) << "预订 ID"
-              << std::setw(12) << "会员 ID"
-              << std::setw(20) << "会员姓名"
-              << std::setw(15) << "ISBN"
-              << std::setw(30) << "书名"
-              << std::setw(18) << "预约日期"
-              << std::setw(10) << "状态" << "\n";
-    std::cout << std::string(120, '=') << "\n";
-
-    int activeCount = 0;
-    for (const auto& reservation : allReservations) {
-        Member* member = memberManager.findMemberByID(reservation.getMemberID());
-        Book* book = bookManager.findBookByISBN(reservation.getISBN());
-
-        std::string memberName = member ? member->getName().substr(0, 18) : "未知";
-        std::string bookTitle = book ? book->getTitle().substr(0, 28) : "未知";
+    size_t offset = 0;
+    do {
+        clearScreen();
+        ui.displayHeader("所有预订");
 
-        if (reservation.getIsActive()) {
-            activeCount++;
+        auto page = reservationManager.getReservationsPage(offset, Config::PAGE_SIZE);
+        if (page.total == 0) {
+            displayMessage("未找到预订", "info");
+            pauseScreen();
+            return;
         }
 
-        std::cout << std::left << std::setw(15) << reservation.getReservationID()
-                  << std::setw(12) << reservation.getMemberID()
-                  << std::setw(20) << memberName
-                  << std::setw(15) << reservation.getISBN()
-                  << std::setw(30) << bookTitle
-                  << std::setw(18) << reservation.getReservationDate()
-                  << std::setw(10) << (reservation.getIsActive() ? "活跃" : "已取消") << "\n";
-    }
-    std::cout << std::string(120, '=') << "\n";
-    std::cout << "预订总数: " << allReservations.size()
-              << " (活跃: " << activeCount << ", 已取消: " << (allReservations.size() - activeCount) << ")\n";
-    std::cout << std::string(120, '=') << "\n";
-
-    pauseScreen();
+        std::cout << "\n" << std::string(120, '=') << "\n";
+        std::cout << std::left << std::setw(15) << "预订 ID"
+                  << std::setw(12) << "会员 ID"
+                  << std::setw(20) << "会员姓名"
+                  << std::setw(15) << "ISBN"
+                  << std::setw(30) << "书名"
+                  << std::setw(18) << "预约日期"
+                  << std::setw(10) << "状态" << "\n";
+        std::cout << std::string(120, '=') << "\n";
+
+        for (const Reservation* reservation : page.items) {
+            Member* member = memberManager.findMemberByID(reservation->getMemberID());
+            Book* book = bookManager.findBookByISBN(reservation->getISBN());
+
+            std::string memberName = member ? member->getName().substr(0, 18) : "未知";
+            std::string bookTitle = book ? book->getTitle().substr(0, 28) : "未知";
+
+            std::cout << std::left << std::setw(15) << reservation->getReservationID()
+                      << std::setw(12) << reservation->getMemberID()
+                      << std::setw(20) << memberName
+                      << std::setw(15) << reservation->getISBN()
+                      << std::setw(30) << bookTitle
+                      << std::setw(18) << reservation->getReservationDate()
+                      << std::setw(10) << (reservation->getIsActive() ? "活跃" : "已取消") << "\n";
+        }
+        // 活跃数由管理器统计, 不必为汇总行遍历全部预订
+        size_t activeCount = static_cast<size_t>(reservationManager.getActiveReservations());
+        std::cout << std::string(120, '=') << "\n";
+        std::cout << "预订总数: " << page.total
+                  << " (活跃: " << activeCount << ", 已取消: " << (page.total - activeCount) << ")\n";
+        std::cout << std::string(120, '=') << "\n";
+    } while (promptPageNavigation(offset, static_cast<size_t>(reservationManager.getTotalReservations())));
 }
 
 void MenuHandler::handleViewActiveReservation() {
@@ -2014,7 +2019,7 @@ void MenuHandler::handleAddReservation() {
         return;
     }
 
-    std::string reservationID = reservationManager.reserveBook(memberID, isbn);
+    std::string reservationID = reservationManager.reserveBook(memberManager, bookManager, memberID, isbn);
 
     if (reservationID == "0") {
         displayMessage("创建预订失败", "error");
@@ -2064,7 +2069,7 @@ void MenuHandler::handleDeleteReservation() {
         return;
     }
 
-    std::string result = reservationManager.cancelReservation(reservationID);
+    std::string result = reservationManager.cancelReservation(bookManager, reservationID);
 
     if (result != "0") {
         displayMessage("预订取消成功!", "success");
@@ -2381,6 +2386,35 @@ void MenuHandler::displayMessage(const std::string& message, const std::string&
     std::cout << "\n";
 }
 
+// 列表翻页: 显示页码并读取 n/p/q, 更新 offset; 返回 false 表示退出列表
+bool MenuHandler::promptPageNavigation(size_t& offset, size_t total) {
+    const size_t pageSize = static_cast<size_t>(Config::PAGE_SIZE);
+    size_t pageCount = (total + pageSize - 1) / pageSize;
+    size_t current = offset / pageSize + 1;
+
+    if (pageCount <= 1) {
+        pauseScreen();
+        return false;
+    }
+
+    std::cout << "第 " << current << "/" << pageCount << " 页, 共 " << total << " 条\n";
+    while (true) {
+        std::string input = promptForInput("n 下一页, p 上一页, q 返回: ");
+        if (input.empty()) {
+            return false;
+        }
+        if ((input == "n" || input == "N") && current < pageCount) {
+            offset += pageSize;
+            return true;
+        }
+        if ((input == "p" || input == "P") && current > 1) {
+            offset -= pageSize;
+            return true;
+        }
+        displayMessage("无效选择", "error");
+    }
+}
+
 void MenuHandler::pauseScreen() {
     std::cout << "\n按下 Enter 以继续...";
     std::cin.clear();
@@ -2417,11 +2451,45 @@ void MenuHandler::performBookSearch(const std::string& searchType) {
         results = bookManager.findByGenre(query);
     } else if (searchType == "publisher") {
         results = bookManager.findByPublisher(query);
+    } else if (searchType == "fuzzy") {
+        results = bookManager.findBestMatches(query);       // 已按相关度排序
     }
 
     displaySearchResults(results);
 }
 
+// 组合搜索: 各项留空即不限, 填写的项按包含匹配, 同时满足才列出
+void MenuHandler::performCombinedBookSearch() {
+    std::cout << "\n各项留空表示不限\n";
+    BookQuery query;
+    std::string title = promptForInput("书名包含: ");
+    if (!title.empty()) {
+        query.whereTitle(title, 1);
+    }
+    std::string author = promptForInput("作者包含: ");
+    if (!author.empty()) {
+        query.whereAuthor(author, 1);
+    }
+    std::string publisher = promptForInput("出版社包含: ");
+    if (!publisher.empty()) {
+        query.wherePublisher(publisher, 1);
+    }
+    std::string genre = promptForInput("类型包含: ");
+    if (!genre.empty()) {
+        query.whereGenre(genre, 1);
+    }
+    query.onlyAvailable(confirmAction("只显示可借的书?"));
+
+    if (!query.title.enabled && !query.author.enabled && !query.publisher.enabled &&
+        !query.genre.enabled && !query.availableOnly) {
+        displayMessage("请至少填写一项搜索条件", "error");
+        pauseScreen();
+        return;
+    }
+
+    displaySearchResults(bookManager.findBooks(query));
+}
+
 void MenuHandler::displaySearchResults(const std::vector<const class Book*>& results) {
     clearScreen();
     ui.displayHeader("搜索结果");
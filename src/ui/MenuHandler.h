@@ -107,9 +107,11 @@ private:
     void displayMessage(const std::string& message, const std::string& type = "info");
     void pauseScreen();
     void clearScreen();
+    bool promptPageNavigation(size_t& offset, size_t total);
 
     // 搜索助手
     void performBookSearch(const std::string& searchType);
+    void performCombinedBookSearch();
     void displaySearchResults(const std::vector<const class Book*>& results);
     void displayBookDetails(Book* book);
 
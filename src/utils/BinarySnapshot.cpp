@@ -0,0 +1,381 @@
+// BinarySnapshot.h 实现
+
+#include "BinarySnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+    #include <sys/stat.h>
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace BinarySnapshot {
+namespace {
+    const char MAGIC[8] = {'L', 'M', 'S', 'S', 'N', 'A', 'P', '2'};     // 2: 修改时间精确到纳秒
+    const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint64_t) + sizeof(int64_t) + 2 * sizeof(uint32_t);
+
+    template<typename T>
+    void append(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // 映射区不保证对齐, 统一用 memcpy 读取
+    template<typename T>
+    T load(const char* p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+
+    // STRING 布局: u32 字节数 | 字节 | (n + 1) x u32 偏移
+    void appendStrings(std::string& out, const std::vector<std::string>& values) {
+        size_t total = 0;
+        for (const auto& value : values) {
+            total += value.size();
+        }
+        append<uint32_t>(out, static_cast<uint32_t>(total));
+        for (const auto& value : values) {
+            out.append(value);
+        }
+        uint32_t offset = 0;
+        append<uint32_t>(out, offset);
+        for (const auto& value : values) {
+            offset += static_cast<uint32_t>(value.size());
+            append<uint32_t>(out, offset);
+        }
+    }
+
+    // 读取源文件大小和修改时间 (纳秒)
+    // 只精确到秒时, 同一秒内大小不变的外部修改会被误判为未修改, 因此取文件系统提供的最高精度
+    bool statSource(const std::string& sourcePath, uint64_t& size, int64_t& mtime) {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA info;
+        if (!GetFileAttributesExA(sourcePath.c_str(), GetFileExInfoStandard, &info)) {
+            return false;
+        }
+        size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+        uint64_t ticks = (static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                         info.ftLastWriteTime.dwLowDateTime;       // 自 1601 年起的 100 纳秒数
+        mtime = static_cast<int64_t>(ticks) * 100;
+#else
+        struct stat info;
+        if (stat(sourcePath.c_str(), &info) != 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(info.st_size);
+    #ifdef __APPLE__
+        long nanoseconds = info.st_mtimespec.tv_nsec;
+    #else
+        long nanoseconds = info.st_mtim.tv_nsec;
+    #endif
+        mtime = static_cast<int64_t>(info.st_mtime) * 1000000000LL + nanoseconds;
+#endif
+        return true;
+    }
+}
+
+// Writer
+Writer::Writer(size_t rowCount) : rowCount(static_cast<uint32_t>(rowCount)) {}
+
+void Writer::addIntColumn(const std::vector<int32_t>& values) {
+    std::string column;
+    column.reserve(1 + values.size() * sizeof(int32_t));
+    column.push_back(static_cast<char>(INT32));
+    column.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int32_t));
+    columns.push_back(std::move(column));
+}
+
+void Writer::addDoubleColumn(const std::vector<double>& values) {
+    std::string column;
+    column.reserve(1 + values.size() * sizeof(double));
+    column.push_back(static_cast<char>(DOUBLE));
+    column.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+    columns.push_back(std::move(column));
+}
+
+void Writer::addDateColumn(const std::vector<Date>& values) {
+    std::vector<int32_t> days;
+    days.reserve(values.size());
+    for (Date value : values) {
+        days.push_back(value.dayNumber());      // 空日期的编码即 EMPTY_DATE
+    }
+
+    std::string column;
+    column.reserve(1 + days.size() * sizeof(int32_t));
+    column.push_back(static_cast<char>(DATE));
+    column.append(reinterpret_cast<const char*>(days.data()), days.size() * sizeof(int32_t));
+    columns.push_back(std::move(column));
+}
+
+void Writer::addStringColumn(const std::vector<std::string>& values, bool intern) {
+    std::string column;
+    if (!intern) {
+        column.push_back(static_cast<char>(STRING));
+        appendStrings(column, values);
+        columns.push_back(std::move(column));
+        return;
+    }
+
+    std::unordered_map<std::string, uint32_t> dictIndex;
+    std::vector<std::string> dictionary;
+    std::vector<uint32_t> indexes;
+    indexes.reserve(values.size());
+    for (const auto& value : values) {
+        auto it = dictIndex.find(value);
+        if (it == dictIndex.end()) {
+            it = dictIndex.emplace(value, static_cast<uint32_t>(dictionary.size())).first;
+            dictionary.push_back(value);
+        }
+        indexes.push_back(it->second);
+    }
+
+    column.push_back(static_cast<char>(DICT));
+    append<uint32_t>(column, static_cast<uint32_t>(dictionary.size()));
+    appendStrings(column, dictionary);
+    column.append(reinterpret_cast<const char*>(indexes.data()), indexes.size() * sizeof(uint32_t));
+    columns.push_back(std::move(column));
+}
+
+void Writer::writeTo(const std::string& snapshotPath, const std::string& sourcePath) const {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime)) {
+        throw std::runtime_error("读取源文件信息错误: " + sourcePath);
+    }
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    append<uint64_t>(header, sourceSize);
+    append<int64_t>(header, sourceMtime);
+    append<uint32_t>(header, rowCount);
+    append<uint32_t>(header, static_cast<uint32_t>(columns.size()));
+
+    // 快照只是 CSV 的加速副本, 丢失时可由 CSV 重建, 因此只保证原子替换而不 fsync
+    const std::string tempPath = snapshotPath + ".tmp";
+    FILE* fp = std::fopen(tempPath.c_str(), "wb");
+    if (fp == nullptr) {
+        throw std::runtime_error("打开文件错误: " + tempPath);
+    }
+    bool ok = std::fwrite(header.data(), 1, header.size(), fp) == header.size();
+    for (const auto& column : columns) {
+        ok = ok && std::fwrite(column.data(), 1, column.size(), fp) == column.size();
+    }
+    ok = std::fclose(fp) == 0 && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tempPath.c_str(), snapshotPath.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && std::rename(tempPath.c_str(), snapshotPath.c_str()) == 0;
+#endif
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("写入快照错误: " + snapshotPath);
+    }
+}
+
+// Reader
+Reader::Reader(const std::string& snapshotPath) : data(nullptr), size(0), mapped(false), rows(0) {
+#ifdef _WIN32
+    FILE* fp = std::fopen(snapshotPath.c_str(), "rb");
+    if (fp == nullptr) {
+        throw std::runtime_error("打开快照错误: " + snapshotPath);
+    }
+    std::fseek(fp, 0, SEEK_END);
+    long length = std::ftell(fp);
+    std::fseek(fp, 0, SEEK_SET);
+    buffer.resize(length > 0 ? static_cast<size_t>(length) : 0);
+    bool ok = length >= 0 && std::fread(buffer.data(), 1, buffer.size(), fp) == buffer.size();
+    std::fclose(fp);
+    if (!ok) {
+        throw std::runtime_error("读取快照错误: " + snapshotPath);
+    }
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = open(snapshotPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("打开快照错误: " + snapshotPath);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        throw std::runtime_error("读取快照错误: " + snapshotPath);
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("映射快照错误: " + snapshotPath);
+    }
+    data = static_cast<const char*>(address);
+    size = static_cast<size_t>(info.st_size);
+    mapped = true;
+#endif
+
+    try {
+        parse();
+    } catch (...) {
+#ifndef _WIN32
+        munmap(const_cast<char*>(data), size);
+#endif
+        throw;
+    }
+}
+
+Reader::~Reader() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+// 私有: 校验文件头并定位每一列, 不拷贝任何数据
+// 字符串偏移和字典下标在此全部校验, 之后按行读取无需再检查边界; 任何不一致都抛出, 由调用方回退到 CSV
+void Reader::parse() {
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("快照格式错误");
+    }
+    const char* p = data + sizeof(MAGIC) + sizeof(uint64_t) + sizeof(int64_t);
+    const char* end = data + size;
+    rows = load<uint32_t>(p);
+    uint32_t columnTotal = load<uint32_t>(p + sizeof(uint32_t));
+    p += 2 * sizeof(uint32_t);
+
+    auto require = [&](size_t bytes) {
+        if (static_cast<size_t>(end - p) < bytes) {
+            throw std::runtime_error("快照文件被截断");
+        }
+    };
+
+    for (uint32_t c = 0; c < columnTotal; c++) {
+        require(1);
+        Column column = {static_cast<ColumnType>(*p), nullptr, nullptr, nullptr};
+        p += 1;
+
+        switch (column.type) {
+            case INT32:
+            case DATE:
+                require(rows * sizeof(int32_t));
+                column.values = p;
+                p += rows * sizeof(int32_t);
+                break;
+            case DOUBLE:
+                require(rows * sizeof(double));
+                column.values = p;
+                p += rows * sizeof(double);
+                break;
+            case STRING:
+            case DICT: {
+                uint32_t entries = rows;
+                if (column.type == DICT) {
+                    require(sizeof(uint32_t));
+                    entries = load<uint32_t>(p);
+                    p += sizeof(uint32_t);
+                }
+                require(sizeof(uint32_t));
+                uint32_t blobSize = load<uint32_t>(p);
+                p += sizeof(uint32_t);
+                require(blobSize);
+                column.blob = p;
+                p += blobSize;
+                require((static_cast<size_t>(entries) + 1) * sizeof(uint32_t));
+                column.offsets = p;
+                p += (static_cast<size_t>(entries) + 1) * sizeof(uint32_t);
+                // 偏移须单调不减且止于字节区末尾, 即每一对都满足 begin <= end <= blobSize
+                uint32_t previous = 0;
+                for (size_t i = 0; i <= entries; i++) {
+                    uint32_t offset = load<uint32_t>(column.offsets + i * sizeof(uint32_t));
+                    if (offset < previous) {
+                        throw std::runtime_error("快照字符串偏移错误");
+                    }
+                    previous = offset;
+                }
+                if (previous != blobSize) {
+                    throw std::runtime_error("快照字符串偏移错误");
+                }
+                if (column.type == DICT) {
+                    require(rows * sizeof(uint32_t));
+                    column.values = p;
+                    p += rows * sizeof(uint32_t);
+                    for (size_t row = 0; row < rows; row++) {
+                        if (load<uint32_t>(column.values + row * sizeof(uint32_t)) >= entries) {
+                            throw std::runtime_error("快照字典下标越界");
+                        }
+                    }
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("快照列类型未知");
+        }
+        columns.push_back(column);
+    }
+}
+
+size_t Reader::rowCount() const {
+    return rows;
+}
+
+size_t Reader::columnCount() const {
+    return columns.size();
+}
+
+ColumnType Reader::columnType(size_t column) const {
+    return columns[column].type;
+}
+
+int32_t Reader::intAt(size_t column, size_t row) const {
+    return load<int32_t>(columns[column].values + row * sizeof(int32_t));
+}
+
+double Reader::doubleAt(size_t column, size_t row) const {
+    return load<double>(columns[column].values + row * sizeof(double));
+}
+
+CSVField Reader::stringAt(size_t column, size_t row) const {
+    const Column& col = columns[column];
+    size_t entry = col.type == DICT ? load<uint32_t>(col.values + row * sizeof(uint32_t)) : row;
+    uint32_t begin = load<uint32_t>(col.offsets + entry * sizeof(uint32_t));
+    uint32_t end = load<uint32_t>(col.offsets + (entry + 1) * sizeof(uint32_t));
+
+    CSVField field;
+    field.data = col.blob + begin;
+    field.size = end - begin;
+    return field;
+}
+
+Date Reader::dateAt(size_t column, size_t row) const {
+    if (columns[column].type != DATE) {
+        return stringAt(column, row).toDate();
+    }
+    return Date(intAt(column, row));
+}
+
+bool isFresh(const std::string& snapshotPath, const std::string& sourcePath) {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMtime)) {
+        return false;
+    }
+
+    FILE* fp = std::fopen(snapshotPath.c_str(), "rb");
+    if (fp == nullptr) {
+        return false;
+    }
+    char header[HEADER_SIZE];
+    bool ok = std::fread(header, 1, HEADER_SIZE, fp) == HEADER_SIZE;
+    std::fclose(fp);
+
+    return ok &&
+           std::memcmp(header, MAGIC, sizeof(MAGIC)) == 0 &&
+           load<uint64_t>(header + sizeof(MAGIC)) == sourceSize &&
+           load<int64_t>(header + sizeof(MAGIC) + sizeof(uint64_t)) == sourceMtime;
+}
+}
@@ -0,0 +1,93 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_BINARYSNAPSHOT_H
+#define LIBRARY_MANAGEMENT_SYSTEM_BINARYSNAPSHOT_H
+
+#include "CSVParser.h"
+#include "Date.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 二进制列式快照: CSV 表的紧凑副本, 启动时映射进内存后几乎无需解析
+//
+// 文件布局 (本机字节序):
+//   "LMSSNAP2" | u64 源 CSV 大小 | i64 源 CSV 修改时间 (纳秒) | u32 行数 | u32 列数 | 各列
+// 列以 u8 类型开头:
+//   INT32  : 行数 x i32
+//   DOUBLE : 行数 x f64
+//   DATE   : 行数 x i32 天数 (自 1970-01-01, EMPTY_DATE 表示空)
+//   STRING : u32 字节数 | 字节 | (行数 + 1) x u32 偏移
+//   DICT   : u32 字典大小 | 字典 (同 STRING 布局) | 行数 x u32 字典下标
+//
+// 快照记录写入时源 CSV 的大小和修改时间, 读取时不一致即视为过期, 回退到 CSV
+namespace BinarySnapshot {
+    enum ColumnType : uint8_t {
+        INT32 = 1,
+        DOUBLE = 2,
+        DATE = 3,
+        STRING = 4,
+        DICT = 5
+    };
+
+    static const int32_t EMPTY_DATE = Date::NONE;
+
+    // 按列构建快照
+    class Writer {
+    private:
+        uint32_t rowCount;
+        std::vector<std::string> columns;          // 每列已编码的字节
+
+    public:
+        explicit Writer(size_t rowCount);
+
+        void addIntColumn(const std::vector<int32_t>& values);
+        void addDoubleColumn(const std::vector<double>& values);
+        // 按天数保存, 空日期记为 EMPTY_DATE
+        void addDateColumn(const std::vector<Date>& values);
+        // intern = true 时以字典保存, 适合 ISBN/会员 ID/类型等大量重复的值
+        void addStringColumn(const std::vector<std::string>& values, bool intern);
+
+        // 原子写入 snapshotPath, 并记录 sourcePath 当前的大小和修改时间
+        void writeTo(const std::string& snapshotPath, const std::string& sourcePath) const;
+    };
+
+    // 映射快照文件并按列读取, 返回的字段视图在 Reader 存活期间有效
+    class Reader {
+    private:
+        struct Column {
+            ColumnType type;
+            const char* values;                     // 定长值或字典下标
+            const char* blob;                       // STRING / DICT 的字节区
+            const char* offsets;                    // STRING / DICT 的偏移表
+        };
+
+        const char* data;
+        size_t size;
+        bool mapped;
+        uint32_t rows;
+        std::vector<Column> columns;
+        std::vector<char> buffer;                   // 无法映射时的读入缓冲区
+
+        void parse();
+
+    public:
+        explicit Reader(const std::string& snapshotPath);
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        size_t rowCount() const;
+        size_t columnCount() const;
+        ColumnType columnType(size_t column) const;
+
+        int32_t intAt(size_t column, size_t row) const;
+        double doubleAt(size_t column, size_t row) const;
+        CSVField stringAt(size_t column, size_t row) const;        // STRING / DICT 列
+        Date dateAt(size_t column, size_t row) const;               // DATE 列; 旧快照中的字典列按字符串解析
+    };
+
+    // 快照存在且与源 CSV 的大小和修改时间一致
+    bool isFresh(const std::string& snapshotPath, const std::string& sourcePath);
+}
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_BINARYSNAPSHOT_H
@@ -0,0 +1,127 @@
+// Bitmap.h 实现
+
+#include "Bitmap.h"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+int Bitmap::popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(word));
+#else
+    int bits = 0;
+    while (word != 0) {
+        word &= word - 1;
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+int Bitmap::lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    int bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+void Bitmap::clear() {
+    words.clear();
+    setCount = 0;
+}
+
+void Bitmap::set(size_t bit) {
+    size_t w = bit / 64;
+    if (w >= words.size()) {
+        words.resize(w + 1, 0);
+    }
+    uint64_t mask = uint64_t(1) << (bit % 64);
+    if ((words[w] & mask) == 0) {
+        words[w] |= mask;
+        setCount++;
+    }
+}
+
+void Bitmap::reset(size_t bit) {
+    size_t w = bit / 64;
+    if (w >= words.size()) {
+        return;
+    }
+    uint64_t mask = uint64_t(1) << (bit % 64);
+    if ((words[w] & mask) != 0) {
+        words[w] &= ~mask;
+        setCount--;
+    }
+}
+
+void Bitmap::assign(size_t bit, bool value) {
+    if (value) {
+        set(bit);
+    } else {
+        reset(bit);
+    }
+}
+
+void Bitmap::erase(size_t bit) {
+    size_t w = bit / 64;
+    if (w >= words.size()) {
+        return;
+    }
+    reset(bit);
+
+    // 本字中 bit 以下的位不动, 以上的位右移一位; 之后每个字右移一位, 并从下一个字借入最低位
+    uint64_t lowMask = (uint64_t(1) << (bit % 64)) - 1;
+    words[w] = (words[w] & lowMask) | ((words[w] >> 1) & ~lowMask);
+    for (size_t i = w; i + 1 < words.size(); i++) {
+        words[i] |= (words[i + 1] & 1) << 63;
+        words[i + 1] >>= 1;
+    }
+}
+
+bool Bitmap::test(size_t bit) const {
+    size_t w = bit / 64;
+    return w < words.size() && (words[w] >> (bit % 64) & 1) != 0;
+}
+
+size_t Bitmap::count() const {
+    return setCount;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    if (words.size() > other.words.size()) {
+        words.resize(other.words.size());
+    }
+    setCount = 0;
+    for (size_t w = 0; w < words.size(); w++) {
+        words[w] &= other.words[w];
+        setCount += popcount(words[w]);
+    }
+    return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    if (words.size() < other.words.size()) {
+        words.resize(other.words.size(), 0);
+    }
+    setCount = 0;
+    for (size_t w = 0; w < words.size(); w++) {
+        if (w < other.words.size()) {
+            words[w] |= other.words[w];
+        }
+        setCount += popcount(words[w]);
+    }
+    return *this;
+}
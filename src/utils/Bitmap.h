@@ -0,0 +1,46 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_BITMAP_H
+#define LIBRARY_MANAGEMENT_SYSTEM_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 稠密位图: 第 i 位表示第 i 行是否满足条件
+// 置位数随修改同步维护, count() 为 O(1); 按位与/或一次处理 64 行
+class Bitmap {
+private:
+    std::vector<uint64_t> words;
+    size_t setCount = 0;
+
+    static int popcount(uint64_t word);
+    static int lowestBit(uint64_t word);        // word 非零
+
+public:
+    void clear();
+    void set(size_t bit);
+    void reset(size_t bit);
+    void assign(size_t bit, bool value);
+    void erase(size_t bit);         // 删除第 bit 位, 其后各位前移一位 (对应删除一行)
+    bool test(size_t bit) const;
+    size_t count() const;
+
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator|=(const Bitmap& other);
+
+    // 按升序对每个置位调用 onBit(size_t); onBit 返回 false 时停止
+    template<typename Callback>
+    void forEach(Callback onBit) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t word = words[w];
+            while (word != 0) {
+                size_t bit = w * 64 + static_cast<size_t>(lowestBit(word));
+                if (!onBit(bit)) {
+                    return;
+                }
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_BITMAP_H
@@ -0,0 +1,96 @@
+// CSVParser.h 实现
+
+#include "CSVParser.h"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+std::string CSVField::toString() const {
+    return std::string(data, size);
+}
+
+int CSVField::toInt() const {
+    size_t i = 0;
+    while (i < size && (data[i] == ' ' || data[i] == '\t')) {
+        i++;
+    }
+
+    bool negative = false;
+    if (i < size && (data[i] == '-' || data[i] == '+')) {
+        negative = data[i] == '-';
+        i++;
+    }
+
+    int value = 0;
+    for (; i < size && data[i] >= '0' && data[i] <= '9'; i++) {
+        value = value * 10 + (data[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+double CSVField::toDouble() const {
+    // 数值字段很短, 拷贝到栈上补齐结尾 '\0' 后交给 strtod
+    char buffer[64];
+    size_t length = size < sizeof(buffer) - 1 ? size : sizeof(buffer) - 1;
+    std::memcpy(buffer, data, length);
+    buffer[length] = '\0';
+    return std::strtod(buffer, nullptr);
+}
+
+bool CSVField::toBool() const {
+    return toInt() != 0;
+}
+
+Date CSVField::toDate() const {
+    const char* begin = data;
+    const char* end = data + size;
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        begin++;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+        end--;
+    }
+
+    Date date;
+    if (!Date::parse(begin, end, date)) {
+        throw std::runtime_error("无效日期: " + std::string(begin, end));
+    }
+    return date;
+}
+
+bool CSVField::equals(const char* text) const {
+    size_t length = std::strlen(text);
+    return length == size && std::memcmp(data, text, size) == 0;
+}
+
+Symbol CSVField::toSymbol() const {
+    return SymbolTable::getInstance().intern(data, size);
+}
+
+namespace CSVParser {
+    size_t splitLine(const char* begin, const char* end, CSVField* fields, size_t maxFields) {
+        for (size_t i = 0; i < maxFields; i++) {
+            fields[i] = CSVField();
+        }
+        if (maxFields == 0) {
+            return 0;
+        }
+
+        size_t count = 0;
+        const char* fieldStart = begin;
+        while (count + 1 < maxFields) {
+            const char* comma = static_cast<const char*>(std::memchr(fieldStart, ',', end - fieldStart));
+            if (comma == nullptr) {
+                break;
+            }
+            fields[count].data = fieldStart;
+            fields[count].size = static_cast<size_t>(comma - fieldStart);
+            count++;
+            fieldStart = comma + 1;
+        }
+
+        fields[count].data = fieldStart;
+        fields[count].size = static_cast<size_t>(end - fieldStart);
+        return count + 1;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_CSVPARSER_H
+#define LIBRARY_MANAGEMENT_SYSTEM_CSVPARSER_H
+
+#include "Date.h"
+#include "SymbolTable.h"
+#include <cstddef>
+#include <string>
+
+// 字段视图: 指向原始行缓冲区中的一段, 不拷贝数据
+// 仅在所属缓冲区存活期间有效
+struct CSVField {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    std::string toString() const;
+    int toInt() const;                  // 解析失败时返回 0
+    double toDouble() const;            // 解析失败时返回 0.0
+    bool toBool() const;                // 非 0 整数为 true
+    Date toDate() const;                // "YYYY-MM-DD", 空字段返回空日期; 格式错误时抛出 std::runtime_error
+    Symbol toSymbol() const;            // 驻留字段内容, 不产生临时字符串
+    bool equals(const char* text) const;
+};
+
+namespace CSVParser {
+    // 以 ',' 拆分 [begin, end) 为最多 maxFields 个字段, 返回实际字段数
+    // 最后一个字段包含行内剩余的全部内容 (含逗号)
+    // 缺少的字段保持为空视图
+    size_t splitLine(const char* begin, const char* end, CSVField* fields, size_t maxFields);
+}
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_CSVPARSER_H
@@ -0,0 +1,182 @@
+// CoBorrowMatrix.h 实现
+
+#include "CoBorrowMatrix.h"
+#include <algorithm>
+#include <cmath>
+
+const size_t CoBorrowMatrix::MAX_HISTORY;
+
+namespace {
+    // 待合并的计数变化超过此数且超过 CSR 非零元的四分之一时整体重建
+    const size_t MIN_PENDING_FOR_COMPACT = 65536;
+}
+
+// 私有: 助手: 取图书的行号, 第一次出现时分配
+uint32_t CoBorrowMatrix::indexOf(uint32_t item) {
+    auto inserted = itemIndex.emplace(item, static_cast<uint32_t>(itemKeys.size()));
+    if (inserted.second) {
+        itemKeys.push_back(item);
+        itemUsers.push_back(0);
+        pending.emplace_back();
+    }
+    return inserted.first->second;
+}
+
+// 私有: 助手: 对称地记录 item 与窗口内各书的共借数变化
+void CoBorrowMatrix::adjust(const std::vector<uint32_t>& window, uint32_t item, int32_t delta) {
+    for (uint32_t other : window) {
+        pending[other].emplace_back(item, delta);
+        pending[item].emplace_back(other, delta);
+    }
+    pendingEntries += 2 * window.size();
+}
+
+void CoBorrowMatrix::clear() {
+    itemIndex.clear();
+    itemKeys.clear();
+    itemUsers.clear();
+    userItems.clear();
+    rowOffsets.clear();
+    columns.clear();
+    counts.clear();
+    pending.clear();
+    pendingEntries = 0;
+    compacted = false;
+    scratchScores.clear();
+    scratchTouched.clear();
+}
+
+void CoBorrowMatrix::add(uint32_t user, uint32_t item) {
+    uint32_t index = indexOf(item);
+    std::vector<uint32_t>& window = userItems[user];
+
+    // 再次借阅窗口内的书: 共借关系不变, 只移到最近
+    auto found = std::find(window.begin(), window.end(), index);
+    if (found != window.end()) {
+        std::rotate(found, found + 1, window.end());
+        return;
+    }
+
+    if (window.size() >= MAX_HISTORY) {
+        uint32_t oldest = window.front();
+        window.erase(window.begin());
+        itemUsers[oldest]--;
+        if (compacted) {
+            adjust(window, oldest, -1);
+        }
+    }
+    if (compacted) {
+        adjust(window, index, 1);
+    }
+    window.push_back(index);
+    itemUsers[index]++;
+
+    if (compacted && pendingEntries > MIN_PENDING_FOR_COMPACT && pendingEntries > columns.size() / 4) {
+        compact();
+    }
+}
+
+// 逐行计算: 第 i 行 = 含有 i 的各窗口中其他书的出现次数, 用稠密计数数组累加, 只输出触及的列
+void CoBorrowMatrix::compact() {
+    size_t itemCount = itemKeys.size();
+    std::vector<const std::vector<uint32_t>*> windows;
+    windows.reserve(userItems.size());
+    std::vector<std::vector<uint32_t>> windowsOfItem(itemCount);
+    for (const auto& entry : userItems) {
+        for (uint32_t index : entry.second) {
+            windowsOfItem[index].push_back(static_cast<uint32_t>(windows.size()));
+        }
+        windows.push_back(&entry.second);
+    }
+
+    rowOffsets.assign(1, 0);
+    rowOffsets.reserve(itemCount + 1);
+    columns.clear();
+    counts.clear();
+    std::vector<uint32_t> accumulator(itemCount, 0);
+    std::vector<uint32_t> touched;
+    for (size_t row = 0; row < itemCount; row++) {
+        for (uint32_t windowIndex : windowsOfItem[row]) {
+            for (uint32_t other : *windows[windowIndex]) {
+                if (other != row && accumulator[other]++ == 0) {
+                    touched.push_back(other);
+                }
+            }
+        }
+        std::sort(touched.begin(), touched.end());
+        for (uint32_t column : touched) {
+            columns.push_back(column);
+            counts.push_back(accumulator[column]);
+            accumulator[column] = 0;
+        }
+        touched.clear();
+        rowOffsets.push_back(columns.size());
+    }
+
+    pending.assign(itemCount, std::vector<std::pair<uint32_t, int32_t>>());
+    pendingEntries = 0;
+    compacted = true;
+}
+
+size_t CoBorrowMatrix::score(uint32_t user, std::unordered_map<uint32_t, double>& scores) const {
+    auto userIt = userItems.find(user);
+    if (userIt == userItems.end()) {
+        return 0;
+    }
+    std::vector<uint32_t> history(userIt->second);
+    std::sort(history.begin(), history.end());
+
+    // 先在按行号的稠密数组中累加, 最后只把得分为正的列写入 scores
+    // 数组在调用间复用, 不随每次调用按整个目录分配和清零
+    for (uint32_t column : scratchTouched) {
+        scratchScores[column] = 0.0;
+    }
+    scratchTouched.clear();
+    if (scratchScores.size() < itemKeys.size()) {
+        scratchScores.resize(itemKeys.size(), 0.0);
+    }
+    std::vector<double>& accumulator = scratchScores;
+    std::vector<uint32_t>& touched = scratchTouched;
+    auto contribute = [&](uint32_t row, uint32_t column, int64_t count) {
+        if (count <= 0) {
+            return;
+        }
+        if (accumulator[column] == 0.0) {
+            touched.push_back(column);
+        }
+        double norm = std::sqrt(static_cast<double>(itemUsers[row]) * static_cast<double>(itemUsers[column]));
+        accumulator[column] += static_cast<double>(count) / norm;
+    };
+
+    // 有待合并变化的行先按列汇总, 再与 CSR 中的计数相加
+    std::unordered_map<uint32_t, int64_t> delta;
+    for (uint32_t row : history) {
+        delta.clear();
+        for (const auto& change : pending[row]) {
+            delta[change.first] += change.second;
+        }
+        if (row + 1 < rowOffsets.size()) {
+            for (size_t k = rowOffsets[row]; k < rowOffsets[row + 1]; k++) {
+                int64_t count = counts[k];
+                if (!delta.empty()) {
+                    auto deltaIt = delta.find(columns[k]);
+                    if (deltaIt != delta.end()) {
+                        count += deltaIt->second;
+                        delta.erase(deltaIt);
+                    }
+                }
+                contribute(row, columns[k], count);
+            }
+        }
+        for (const auto& change : delta) {
+            contribute(row, change.first, change.second);
+        }
+    }
+
+    for (uint32_t column : touched) {
+        if (!std::binary_search(history.begin(), history.end(), column)) {
+            scores[itemKeys[column]] += accumulator[column];
+        }
+    }
+    return history.size();
+}
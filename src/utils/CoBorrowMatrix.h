@@ -0,0 +1,55 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_COBORROWMATRIX_H
+#define LIBRARY_MANAGEMENT_SYSTEM_COBORROWMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 图书共借矩阵 (item-item): co(i, j) = 同时借过 i 和 j 的会员数, 以 CSR (压缩稀疏行) 存放
+// 每个会员只计最近借阅的 MAX_HISTORY 本不同的书, 矩阵规模为 Σ min(d, MAX_HISTORY)^2, 不随借阅最多的会员平方增长
+// 增量: add 把计数变化暂存在各行的待合并列表中, 累积到一定数量时 compact 重建 CSR
+// 会员和图书以调用方给出的 32 位键 (驻留句柄) 标识, 内部另行编为连续的行号
+class CoBorrowMatrix {
+private:
+    std::unordered_map<uint32_t, uint32_t> itemIndex;               // 键 -> 行号
+    std::vector<uint32_t> itemKeys;                                 // 行号 -> 键
+    std::vector<uint32_t> itemUsers;                                // 行号 -> 窗口中含有该书的会员数
+    std::unordered_map<uint32_t, std::vector<uint32_t>> userItems;  // 会员 -> 最近借阅的不同书目 (行号, 按借阅先后)
+
+    // CSR: 第 i 行的非零元为 columns/counts[rowOffsets[i], rowOffsets[i + 1]), 列号升序
+    // 只覆盖上次 compact 时已有的行, 之后新出现的书只有待合并部分
+    std::vector<size_t> rowOffsets;
+    std::vector<uint32_t> columns;
+    std::vector<uint32_t> counts;
+
+    std::vector<std::vector<std::pair<uint32_t, int32_t>>> pending;     // 行号 -> (列号, 计数变化)
+    size_t pendingEntries = 0;
+    bool compacted = false;     // clear 后尚未 compact 时 add 只记录借阅关系, 共借计数留给 compact 一次算出
+
+    // score 的按行号稠密累加数组, 调用间复用; 下次调用开始时只把上次触及的列清零
+    mutable std::vector<double> scratchScores;
+    mutable std::vector<uint32_t> scratchTouched;
+
+    uint32_t indexOf(uint32_t item);
+    void adjust(const std::vector<uint32_t>& window, uint32_t item, int32_t delta);     // item 与窗口内各书的共借数变化 delta
+
+public:
+    static const size_t MAX_HISTORY = 32;  // 留一法命中率在 24~32 本时已饱和, 更大的窗口只增加构建时间和内存
+
+    void clear();
+
+    // 记录 user 借阅 item; 窗口内已有的书只更新先后顺序, 窗口满时移出最早的一本
+    void add(uint32_t user, uint32_t item);
+
+    // 由各会员的窗口重建 CSR 并清空待合并列表
+    void compact();
+
+    // 基于物品的协同过滤: 对 user 窗口中的每本书 i, 共借过的其他书 j 得分增加 co(i, j) / sqrt(n(i) * n(j))
+    // (即两书借阅者集合的余弦相似度), 累加到 scores (键 -> 分数); 窗口中的书不计分
+    // 返回 user 窗口中的书数, 为 0 表示没有借阅记录
+    size_t score(uint32_t user, std::unordered_map<uint32_t, double>& scores) const;
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_COBORROWMATRIX_H
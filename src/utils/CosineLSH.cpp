@@ -0,0 +1,118 @@
+// CosineLSH.h 实现
+
+#include "CosineLSH.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+CosineLSH::CosineLSH(size_t tables, size_t bits) : tableCount(tables), bitCount(bits) {
+    if (tables == 0 || bits == 0 || bits > 32) {
+        throw std::runtime_error("LSH 表数须大于 0, 位数须在 1 到 32 之间");
+    }
+}
+
+// 私有: 助手: 向量在第 table 张表中的签名
+uint32_t CosineLSH::signature(size_t table, const float* vector) const {
+    uint32_t value = 0;
+    const float* plane = planes.data() + table * bitCount * dimension;
+    for (size_t bit = 0; bit < bitCount; bit++, plane += dimension) {
+        float side = 0.0f;
+        for (size_t i = 0; i < dimension; i++) {
+            side += plane[i] * vector[i];
+        }
+        if (side >= 0.0f) {
+            value |= 1u << bit;
+        }
+    }
+    return value;
+}
+
+// 私有: 助手: 把条目从各表的桶中移出 (与桶尾交换)
+void CosineLSH::unlink(uint32_t id) {
+    for (size_t table = 0; table < tableCount; table++) {
+        size_t slot = static_cast<size_t>(id) * tableCount + table;
+        auto bucketIt = buckets[table].find(signatures[slot]);
+        std::vector<uint32_t>& bucket = bucketIt->second;
+        uint32_t moved = bucket.back();
+        bucket[positions[slot]] = moved;
+        positions[static_cast<size_t>(moved) * tableCount + table] = positions[slot];
+        bucket.pop_back();
+        if (bucket.empty()) {
+            buckets[table].erase(bucketIt);
+        }
+    }
+    indexed[id] = false;
+}
+
+void CosineLSH::reset(size_t newDimension) {
+    dimension = newDimension;
+    buckets.assign(tableCount, std::unordered_map<uint32_t, std::vector<uint32_t>>());
+    signatures.clear();
+    positions.clear();
+    indexed.clear();
+    visitStamp.clear();
+    currentStamp = 0;
+
+    // 各分量独立取标准正态分布, 超平面法向量在球面上均匀分布
+    std::mt19937 generator(20240521u);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    planes.resize(tableCount * bitCount * dimension);
+    for (float& value : planes) {
+        value = normal(generator);
+    }
+}
+
+void CosineLSH::update(uint32_t id, const float* vector) {
+    if (id >= indexed.size()) {
+        indexed.resize(static_cast<size_t>(id) + 1, false);
+        signatures.resize(indexed.size() * tableCount, 0);
+        positions.resize(indexed.size() * tableCount, 0);
+    }
+    if (indexed[id]) {
+        unlink(id);
+    }
+
+    bool zero = true;
+    for (size_t i = 0; i < dimension; i++) {
+        if (vector[i] != 0.0f) {
+            zero = false;
+            break;
+        }
+    }
+    if (zero) {
+        return;
+    }
+
+    for (size_t table = 0; table < tableCount; table++) {
+        size_t slot = static_cast<size_t>(id) * tableCount + table;
+        signatures[slot] = signature(table, vector);
+        std::vector<uint32_t>& bucket = buckets[table][signatures[slot]];
+        positions[slot] = static_cast<uint32_t>(bucket.size());
+        bucket.push_back(id);
+    }
+    indexed[id] = true;
+}
+
+void CosineLSH::candidates(const float* query, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (visitStamp.size() < indexed.size()) {
+        visitStamp.resize(indexed.size(), 0);
+    }
+    if (++currentStamp == 0) {      // 计数回绕时整体清零
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        currentStamp = 1;
+    }
+
+    for (size_t table = 0; table < tableCount; table++) {
+        auto bucketIt = buckets[table].find(signature(table, query));
+        if (bucketIt == buckets[table].end()) {
+            continue;
+        }
+        for (uint32_t id : bucketIt->second) {
+            if (visitStamp[id] != currentStamp) {
+                visitStamp[id] = currentStamp;
+                out.push_back(id);
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_COSINELSH_H
+#define LIBRARY_MANAGEMENT_SYSTEM_COSINELSH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 随机超平面局部敏感哈希 (SimHash), 用于按余弦相似度近似查找最近邻
+// 每张表取 bits 个随机超平面, 向量落在各超平面哪一侧组成签名; 夹角为 θ 的两向量每一位相同的概率为 1 - θ/π
+// 查询取各表中与查询签名相同的桶的并集作为候选, 由调用方再按精确相似度排序; 表越多召回越高, 位数越多候选越少
+// 条目以调用方的连续编号 (行号) 标识, update 可随时插入或移动单个条目; 零向量不入索引
+// 超平面由固定种子生成, 同样的数据总是得到同样的候选
+class CosineLSH {
+private:
+    size_t dimension = 0;
+    size_t tableCount;
+    size_t bitCount;
+    std::vector<float> planes;                                              // [表][位][维]
+    std::vector<std::unordered_map<uint32_t, std::vector<uint32_t>>> buckets;  // 表 -> 签名 -> 条目
+    std::vector<uint32_t> signatures;                                       // [条目][表]
+    std::vector<uint32_t> positions;                                        // [条目][表] -> 在桶中的下标, 用于 O(1) 移出
+    std::vector<bool> indexed;
+
+    mutable std::vector<uint32_t> visitStamp;   // 查询去重用, 避免每次清零
+    mutable uint32_t currentStamp = 0;
+
+    uint32_t signature(size_t table, const float* vector) const;
+    void unlink(uint32_t id);
+
+public:
+    CosineLSH(size_t tables, size_t bits);
+
+    // 清空并按新的维数生成超平面
+    void reset(size_t dimension);
+
+    // 插入或更新条目 id 的向量 (长度为 dimension)
+    void update(uint32_t id, const float* vector);
+
+    // 与 query 至少在一张表中同桶的条目, 去重, 顺序不定
+    void candidates(const float* query, std::vector<uint32_t>& out) const;
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_COSINELSH_H
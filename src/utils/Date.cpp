@@ -0,0 +1,80 @@
+// Date.h 实现
+
+#include "Date.h"
+
+constexpr int32_t Date::NONE;
+
+// 解析 "YYYY-MM-DD"; 逐字符处理, 不经过 sscanf 和区域设置
+bool Date::parse(const char* begin, const char* end, Date& out) {
+    if (begin == end) {
+        out = Date();
+        return true;
+    }
+
+    int32_t parts[3] = {0, 0, 0};
+    int digits[3] = {0, 0, 0};
+    int part = 0;
+    for (const char* p = begin; p < end; p++) {
+        if (*p == '-') {
+            if (++part > 2) {
+                return false;
+            }
+        } else if (*p >= '0' && *p <= '9') {
+            parts[part] = parts[part] * 10 + (*p - '0');
+            digits[part]++;
+        } else {
+            return false;
+        }
+    }
+    if (part != 2 || digits[0] != 4 || digits[1] < 1 || digits[1] > 2 || digits[2] < 1 || digits[2] > 2) {
+        return false;
+    }
+
+    int32_t year = parts[0];
+    int32_t month = parts[1];
+    int32_t day = parts[2];
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+
+    // 往返校验, 排除 02-30 之类不存在的日期
+    Date date = fromCivil(year, month, day);
+    if (date.day() != day) {
+        return false;
+    }
+    out = date;
+    return true;
+}
+
+Date Date::parse(const std::string& text) {
+    Date date;
+    parse(text.data(), text.data() + text.size(), date);
+    return date;
+}
+
+std::string Date::toString() const {
+    std::string text;
+    appendTo(text);
+    return text;
+}
+
+// 手工格式化, 避免 snprintf/strftime 的区域设置开销
+void Date::appendTo(std::string& out) const {
+    if (empty()) {
+        return;
+    }
+    int32_t y = year();
+    int32_t m = month();
+    int32_t d = day();
+    char buffer[10] = {
+        static_cast<char>('0' + y / 1000 % 10), static_cast<char>('0' + y / 100 % 10),
+        static_cast<char>('0' + y / 10 % 10), static_cast<char>('0' + y % 10), '-',
+        static_cast<char>('0' + m / 10), static_cast<char>('0' + m % 10), '-',
+        static_cast<char>('0' + d / 10), static_cast<char>('0' + d % 10)
+    };
+    out.append(buffer, sizeof(buffer));
+}
+
+std::ostream& operator<<(std::ostream& os, Date date) {
+    return os << date.toString();
+}
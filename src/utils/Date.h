@@ -0,0 +1,94 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_DATE_H
+#define LIBRARY_MANAGEMENT_SYSTEM_DATE_H
+
+#include <climits>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// 紧凑日期: 保存自 1970-01-01 起的天数 (公历, 与时区无关), 只占 4 字节
+// 比较与加减都是整数运算; 只在读写 CSV 和界面显示时与 "YYYY-MM-DD" 互相转换
+// 默认构造为空日期 (例如尚未归还的交易的归还日), 空日期早于任何日期
+class Date {
+private:
+    int32_t days;
+
+    // 公历 <-> 天数换算 (Howard Hinnant 的 days_from_civil / civil_from_days 算法)
+    // 拆成单条 return 的小函数, 以满足 C++11 constexpr 的限制; 年份从 3 月起算, 闰日落在年末
+    static constexpr int32_t eraOfYear(int32_t year) {
+        return (year >= 0 ? year : year - 399) / 400;
+    }
+    static constexpr int32_t dayOfYearFor(int32_t month, int32_t day) {
+        return (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    }
+    static constexpr int32_t daysFromShiftedYear(int32_t year, int32_t dayOfYear) {
+        return eraOfYear(year) * 146097 +
+               (year - eraOfYear(year) * 400) * 365 + (year - eraOfYear(year) * 400) / 4 -
+               (year - eraOfYear(year) * 400) / 100 + dayOfYear - 719468;
+    }
+
+    static constexpr int32_t eraOfDay(int32_t shifted) {
+        return (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+    }
+    static constexpr int32_t dayOfEra(int32_t dayNumber) {
+        return (dayNumber + 719468) - eraOfDay(dayNumber + 719468) * 146097;
+    }
+    static constexpr int32_t yearOfEra(int32_t dayOfEra) {
+        return (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    }
+    static constexpr int32_t dayOfShiftedYear(int32_t dayOfEra) {
+        return dayOfEra - (365 * yearOfEra(dayOfEra) + yearOfEra(dayOfEra) / 4 - yearOfEra(dayOfEra) / 100);
+    }
+    static constexpr int32_t shiftedMonth(int32_t dayOfYear) {
+        return (5 * dayOfYear + 2) / 153;
+    }
+
+public:
+    static constexpr int32_t NONE = INT32_MIN;      // 空日期的天数编码
+
+    constexpr Date() : days(NONE) {}
+    constexpr explicit Date(int32_t dayNumber) : days(dayNumber) {}
+
+    // 由年月日构造, 不做范围检查 (需要检查时用 parse)
+    static constexpr Date fromCivil(int32_t year, int32_t month, int32_t day) {
+        return Date(daysFromShiftedYear(year - (month <= 2 ? 1 : 0), dayOfYearFor(month, day)));
+    }
+
+    constexpr bool empty() const { return days == NONE; }
+    constexpr int32_t dayNumber() const { return days; }
+
+    constexpr int32_t month() const {
+        return shiftedMonth(dayOfShiftedYear(dayOfEra(days))) < 10 ?
+               shiftedMonth(dayOfShiftedYear(dayOfEra(days))) + 3 :
+               shiftedMonth(dayOfShiftedYear(dayOfEra(days))) - 9;
+    }
+    constexpr int32_t day() const {
+        return dayOfShiftedYear(dayOfEra(days)) - (153 * shiftedMonth(dayOfShiftedYear(dayOfEra(days))) + 2) / 5 + 1;
+    }
+    constexpr int32_t year() const {
+        return yearOfEra(dayOfEra(days)) + eraOfDay(days + 719468) * 400 + (month() <= 2 ? 1 : 0);
+    }
+
+    // 日期运算, 空日期保持为空; 任一端为空时相隔天数为 0 (NONE 参与相减会溢出)
+    constexpr Date addDays(int32_t count) const { return empty() ? *this : Date(days + count); }
+    constexpr int32_t daysUntil(Date other) const { return empty() || other.empty() ? 0 : other.days - days; }
+
+    constexpr bool operator==(Date other) const { return days == other.days; }
+    constexpr bool operator!=(Date other) const { return days != other.days; }
+    constexpr bool operator<(Date other) const { return days < other.days; }
+    constexpr bool operator<=(Date other) const { return days <= other.days; }
+    constexpr bool operator>(Date other) const { return days > other.days; }
+    constexpr bool operator>=(Date other) const { return days >= other.days; }
+
+    // 字符串边界
+    // 解析 "YYYY-MM-DD" (月/日允许一位数字); 空串得到空日期
+    // 格式错误或日期不存在 (如 02-30) 时返回 false, out 不变
+    static bool parse(const char* begin, const char* end, Date& out);
+    static Date parse(const std::string& text);     // 无法解析时返回空日期
+    std::string toString() const;                   // 规范 "YYYY-MM-DD", 空日期返回空串
+    void appendTo(std::string& out) const;          // 追加到 out 末尾, 不产生临时字符串
+};
+
+std::ostream& operator<<(std::ostream& os, Date date);
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_DATE_H
@@ -3,46 +3,106 @@
 #include "DateUtils.h"
 #include <ctime>
 #include <string>
-#include <sstream>
+
+namespace {
+    // 一个本地日期及其起止时间戳: [dayStart, dayEnd) 内的时间都属于 day
+    // 夏令时切换日的长度不是 86400 秒, 因此起止时间由 mktime 求出而不是推算
+    struct LocalDay {
+        time_t dayStart = 0;
+        time_t dayEnd = 0;          // 0 表示尚未计算
+        Date day;
+    };
+
+    // 当天的缓存, 每个线程各持一份, 读取时既不加锁也不调用 localtime
+    // 时钟越过午夜 (或被回拨到当天之前) 时才重新计算一次
+    thread_local LocalDay todayCache;
+
+    // 线程安全的 localtime
+    void toLocalTime(time_t timestamp, std::tm& out) {
+#ifdef _WIN32
+        localtime_s(&out, &timestamp);
+#else
+        localtime_r(&timestamp, &out);
+#endif
+    }
+
+    time_t localMidnight(const std::tm& tm, int dayOffset) {
+        std::tm midnight = {};
+        midnight.tm_year = tm.tm_year;
+        midnight.tm_mon = tm.tm_mon;
+        midnight.tm_mday = tm.tm_mday + dayOffset;      // mktime 会规范化越界的日
+        midnight.tm_isdst = -1;
+        return std::mktime(&midnight);
+    }
+
+    void computeLocalDay(time_t timestamp, LocalDay& out) {
+        std::tm tm = {};
+        toLocalTime(timestamp, tm);
+        out.day = Date::fromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+        out.dayStart = localMidnight(tm, 0);
+        out.dayEnd = localMidnight(tm, 1);
+    }
+
+    bool contains(const LocalDay& localDay, time_t timestamp) {
+        return timestamp >= localDay.dayStart && timestamp < localDay.dayEnd;
+    }
+
+    const LocalDay& currentDay(time_t now) {
+        if (!contains(todayCache, now)) {
+            computeLocalDay(now, todayCache);
+        }
+        return todayCache;
+    }
+
+    void appendTwoDigits(std::string& out, int value) {
+        out.push_back(static_cast<char>('0' + value / 10));
+        out.push_back(static_cast<char>('0' + value % 10));
+    }
+}
 
 namespace DateUtils {
+    // 今天的日期直接取缓存中的午夜时间戳; 其他日期经 mktime 换算
     time_t dateToTimestamp(const std::string& dateString) {
-        int year = 0;
-        int month = 0;
-        int day = 0;
-
-        if (std::sscanf(dateString.c_str(), "%d-%d-%d", &year, &month, &day) != 3) {
+        Date date;
+        if (!Date::parse(dateString.data(), dateString.data() + dateString.size(), date) || date.empty()) {
             return 0;                       // 解析失败时返回 0, 调用者将得到 1970-01-01
         }
+
+        const LocalDay& current = currentDay(std::time(nullptr));
+        if (date == current.day) {
+            return current.dayStart;
+        }
         std::tm tm = {};
-        tm.tm_year = year - 1900;
-        tm.tm_mon = month - 1;
-        tm.tm_mday = day;
+        tm.tm_year = date.year() - 1900;
+        tm.tm_mon = date.month() - 1;
+        tm.tm_mday = date.day();
         tm.tm_isdst = -1;
 
-        return mktime(&tm);
+        return std::mktime(&tm);
     }
 
     std::string timestampToDate(time_t timestamp) {
-        std::tm *tm = std::localtime(&timestamp);
-        char buffer[11];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d", tm);
-
-        return buffer;
+        return toLocalDateTime(timestamp).date.toString();
     }
 
     std::string getCurrentDate() {
-        return timestampToDate(std::time(nullptr));
-        // return timestampToDate(time(0));
+        return today().toString();
     }
 
     std::string getCurrentDateTime() {
-        time_t timestamp = std::time(nullptr);
-        std::tm *tm = std::localtime(&timestamp);
-        char buffer[20];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", tm);
+        LocalDateTime now = toLocalDateTime(std::time(nullptr));
 
-        return buffer;
+        // 手工格式化 "YYYY-MM-DD HH:MM:SS", 不经过 strftime 的区域设置
+        std::string text;
+        text.reserve(19);
+        now.date.appendTo(text);
+        text.push_back(' ');
+        appendTwoDigits(text, now.hour);
+        text.push_back(':');
+        appendTwoDigits(text, now.minute);
+        text.push_back(':');
+        appendTwoDigits(text, now.second);
+        return text;
     }
 
     time_t getCurrentTimestamp() {
@@ -58,8 +118,38 @@ namespace DateUtils {
     }
 
     std::string addDays(const std::string& dateString, int addition) {
+        Date date = Date::parse(dateString);
+        if (!date.empty()) {
+            return date.addDays(addition).toString();
+        }
         time_t dateTimestamp = dateToTimestamp(dateString);
         time_t targetTimestamp = dateTimestamp + (addition * 86400);
         return timestampToDate(targetTimestamp);
     }
+
+    Date today() {
+        return currentDay(std::time(nullptr)).day;
+    }
+
+    // 落在缓存的当天内且当天为完整的 24 小时时, 时分秒由距午夜的秒数算出; 否则调用一次 localtime_r
+    LocalDateTime toLocalDateTime(time_t timestamp) {
+        LocalDateTime result;
+        const LocalDay& current = currentDay(std::time(nullptr));
+        if (contains(current, timestamp) && current.dayEnd - current.dayStart == 86400) {
+            int secondsOfDay = static_cast<int>(timestamp - current.dayStart);
+            result.date = current.day;
+            result.hour = secondsOfDay / 3600;
+            result.minute = secondsOfDay / 60 % 60;
+            result.second = secondsOfDay % 60;
+            return result;
+        }
+
+        std::tm tm = {};
+        toLocalTime(timestamp, tm);
+        result.date = Date::fromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+        result.hour = tm.tm_hour;
+        result.minute = tm.tm_min;
+        result.second = tm.tm_sec;
+        return result;
+    }
 }
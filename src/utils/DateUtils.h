@@ -1,10 +1,19 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_DATEUTILS_H
 #define LIBRARY_MANAGEMENT_SYSTEM_DATEUTILS_H
 
+#include "Date.h"
 #include <string>
 #include <ctime>
 
 namespace DateUtils{
+// 本地时间的分解结果
+struct LocalDateTime {
+    Date date;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+};
+
 // 转换 YYYY-MM-DD 到 UNIX 时间戳
 time_t dateToTimestamp(const std::string& dateString);
 
@@ -23,8 +32,15 @@ time_t getCurrentTimestamp();
 // 计算天数间隔
 unsigned int daysBetween(time_t startTime, time_t endTime);
 
-// 天数增量
+// 天数增量 (字符串版本, 模型内部请直接使用 Date::addDays)
 std::string addDays(const std::string& dateString, int addition);
+
+// 今天 (本地时区)
+// 每个线程缓存当天的日期及其起止时间, 跨过午夜后才重新计算, 平时只需一次 time() 调用
+Date today();
+
+// 将时间戳分解为本地日期与时分秒, 当天内的时间戳不调用 localtime
+LocalDateTime toLocalDateTime(time_t timestamp);
 }
 
 #endif //LIBRARY_MANAGEMENT_SYSTEM_DATEUTILS_H
@@ -1,48 +1,333 @@
 // FileHandler.h 实现
 
 #include "FileHandler.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #ifdef _WIN32
     #include <direct.h>         // _mkdir for Windows
+    #include <fcntl.h>          // _O_RDWR for Windows
+    #include <io.h>             // _commit for Windows
     #include <sys/stat.h>
     #include <windows.h>
 #else
+    #include <fcntl.h>          // open for Unix
     #include <sys/stat.h>       // mkdir/stat for Unix
     #include <unistd.h>
 #endif
 
+namespace {
+    // CRC-32 (IEEE 802.3), 用于日志记录的校验
+    uint32_t crc32(const char* data, size_t size) {
+        static uint32_t table[256];
+        static bool initialized = false;
+        if (!initialized) {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                table[i] = value;
+            }
+            initialized = true;
+        }
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    const size_t RECORD_HEADER_SIZE = 9;        // 8 位十六进制校验码 + 空格
+
+    // 记录行 [begin, end) 校验通过时返回 true
+    bool verifyRecord(const char* begin, const char* end) {
+        if (static_cast<size_t>(end - begin) < RECORD_HEADER_SIZE || begin[8] != ' ') {
+            return false;
+        }
+        uint32_t expected = 0;
+        for (int i = 0; i < 8; i++) {
+            char c = begin[i];
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            expected = expected << 4 | static_cast<uint32_t>(digit);
+        }
+        return crc32(begin + RECORD_HEADER_SIZE, static_cast<size_t>(end - begin) - RECORD_HEADER_SIZE) == expected;
+    }
+}
 
 std::vector<std::string> FileHandler::readCSV(const std::string& filePath) {
-    if (cache.find(filePath) != cache.end()) {
-        return cache[filePath];
+    return *readCSVShared(filePath);
+}
+
+FileHandler::SharedLines FileHandler::readCSVShared(const std::string& filePath) {
+    auto it = cache.find(filePath);
+    if (it != cache.end()) {
+        return it->second;
     }
 
     std::ifstream ifs(filePath);
     if (!ifs.is_open()) {
         throw std::runtime_error ("打开文件错误: " + filePath);
     }
-    std::vector<std::string> lines;
+    std::shared_ptr<std::vector<std::string>> lines = std::make_shared<std::vector<std::string>>();
     std::string line;
 
     while (std::getline(ifs, line)) {
-        lines.push_back(line);
+        lines->push_back(line);
+    }
+    if (isCacheEnabled(filePath)) {
+        cache[filePath] = lines;
     }
-    cache[filePath] = lines;
 
     return lines;
 }
 
-void FileHandler::writeCSV(const std::string& filePath, const std::vector<std::string>& lines) {
-    std::ofstream ofs(filePath);
-    if (!ofs.is_open()) {
+void FileHandler::forEachLine(const std::string& filePath,
+                              const std::function<void(const char* begin, const char* end)>& onLine) {
+    FILE* fp = std::fopen(filePath.c_str(), "rb");
+    if (fp == nullptr) {
         throw std::runtime_error ("打开文件错误: " + filePath);
     }
+
+    // 每次读入一块, 处理其中的完整行, 不完整的尾行移到缓冲区开头与下一块拼接
+    const size_t blockSize = 1 << 20;
+    std::vector<char> buffer(blockSize);
+    size_t pending = 0;
+
+    try {
+        while (true) {
+            if (pending == buffer.size()) {
+                buffer.resize(buffer.size() * 2);           // 单行超过缓冲区时扩容
+            }
+            size_t bytesRead = std::fread(buffer.data() + pending, 1, buffer.size() - pending, fp);
+            size_t available = pending + bytesRead;
+            bool eof = bytesRead == 0;
+
+            const char* lineStart = buffer.data();
+            const char* dataEnd = buffer.data() + available;
+            while (lineStart < dataEnd) {
+                const char* newline = static_cast<const char*>(std::memchr(lineStart, '\n', dataEnd - lineStart));
+                if (newline == nullptr) {
+                    break;
+                }
+                onLine(lineStart, newline);
+                lineStart = newline + 1;
+            }
+
+            pending = static_cast<size_t>(dataEnd - lineStart);
+            if (eof) {
+                if (pending > 0) {
+                    onLine(lineStart, dataEnd);             // 文件末尾没有换行符的最后一行
+                }
+                break;
+            }
+            std::memmove(buffer.data(), lineStart, pending);
+        }
+    } catch (...) {
+        std::fclose(fp);        // 回调抛出异常时也要关闭文件
+        throw;
+    }
+
+    bool failed = std::ferror(fp) != 0;
+    std::fclose(fp);
+    if (failed) {
+        throw std::runtime_error ("读取文件错误: " + filePath);
+    }
+}
+
+void FileHandler::writeCSV(const std::string& filePath, const std::vector<std::string>& lines) {
+    writeLines(filePath, lines);
+
+    if (isCacheEnabled(filePath)) {
+        cache[filePath] = std::make_shared<const std::vector<std::string>>(lines);
+    } else {
+        cache.erase(filePath);
+    }
+}
+
+void FileHandler::writeCSV(const std::string& filePath, std::vector<std::string>&& lines) {
+    writeLines(filePath, lines);
+
+    if (isCacheEnabled(filePath)) {
+        cache[filePath] = std::make_shared<const std::vector<std::string>>(std::move(lines));
+    } else {
+        cache.erase(filePath);
+    }
+}
+
+// 私有: 将各行写入磁盘, 不触碰缓存
+// 先写入同目录下的临时文件并 fsync, 再以 rename 原子替换目标文件, 最后 fsync 目录,
+// 保证任意时刻崩溃后目标文件要么是旧版本要么是完整的新版本
+void FileHandler::writeLines(const std::string& filePath, const std::vector<std::string>& lines) {
+    const std::string tempPath = filePath + ".tmp";
+    FILE* fp = std::fopen(tempPath.c_str(), "wb");
+    if (fp == nullptr) {
+        throw std::runtime_error ("打开文件错误: " + tempPath);
+    }
+
+    // 行先拼入内存块, 满一块再整体写出
+    const size_t blockSize = 1 << 20;
+    std::string block;
+    block.reserve(blockSize + 256);
+
+    bool ok = true;
     for (const auto& line : lines) {
-        ofs << line << "\n";
+        block.append(line);
+        block.push_back('\n');
+        if (block.size() >= blockSize) {
+            ok = ok && std::fwrite(block.data(), 1, block.size(), fp) == block.size();
+            block.clear();
+        }
+    }
+    ok = ok && std::fwrite(block.data(), 1, block.size(), fp) == block.size();
+    ok = ok && std::fflush(fp) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(fp)) == 0;
+#else
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = std::fclose(fp) == 0 && ok;
+
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error ("写入文件错误: " + tempPath);
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error ("替换文件错误: " + filePath);
+    }
+#else
+    if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error ("替换文件错误: " + filePath);
+    }
+
+    // rename 只有在目录项落盘后才算持久
+    size_t slash = filePath.find_last_of('/');
+    std::string dirPath = slash == std::string::npos ? "." : filePath.substr(0, slash + 1);
+    int dirFd = open(dirPath.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+#endif
+}
+
+void FileHandler::truncateFile(const std::string& filePath, long long size) {
+#ifdef _WIN32
+    int fd = _open(filePath.c_str(), _O_RDWR | _O_BINARY);
+    bool ok = fd >= 0 && _chsize_s(fd, size) == 0 && _commit(fd) == 0;
+    if (fd >= 0) {
+        _close(fd);
+    }
+#else
+    int fd = open(filePath.c_str(), O_RDWR);
+    bool ok = fd >= 0 && ftruncate(fd, static_cast<off_t>(size)) == 0 && fsync(fd) == 0;
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+    if (!ok) {
+        throw std::runtime_error ("截断文件错误: " + filePath);
+    }
+}
+
+// 追加写入: 单条记录写入后 fsync, 保证返回时已落盘
+void FileHandler::appendRecord(const std::string& filePath, const std::string& record) {
+    appendRecords(filePath, std::vector<std::string>(1, record));
+}
+
+// 追加写入多条: 一次写出后只 fsync 一次, 供组提交合并多条日志记录
+// 写入失败时把文件截回写入前的长度, 不留下半条记录
+void FileHandler::appendRecords(const std::string& filePath, const std::vector<std::string>& records) {
+    if (records.empty()) {
+        return;
+    }
+    FILE* fp = std::fopen(filePath.c_str(), "ab");
+    if (fp == nullptr) {
+        throw std::runtime_error ("打开文件错误: " + filePath);
+    }
+
+    std::string data;
+    char header[RECORD_HEADER_SIZE + 1];
+    for (const auto& record : records) {
+        std::snprintf(header, sizeof(header), "%08x ",
+                      static_cast<unsigned int>(crc32(record.data(), record.size())));
+        data.append(header, RECORD_HEADER_SIZE);
+        data.append(record);
+        data.push_back('\n');
+    }
+
+    bool ok = std::fseek(fp, 0, SEEK_END) == 0;
+    long originalSize = ok ? std::ftell(fp) : -1;
+    ok = ok && originalSize >= 0 &&
+         std::fwrite(data.data(), 1, data.size(), fp) == data.size() &&
+         std::fflush(fp) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(fp)) == 0;
+#else
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    std::fclose(fp);
+    if (!ok) {
+        if (originalSize >= 0) {
+            try {
+                truncateFile(filePath, originalSize);
+            } catch (std::exception&) {
+                // 截断失败时残留的半条记录校验不通过, 下次重放时截掉
+            }
+        }
+        throw std::runtime_error ("写入文件错误: " + filePath);
+    }
+
+    // 缓存缓冲区不可变, 追加后直接失效, 下次读取时重新加载
+    cache.erase(filePath);
+}
+
+void FileHandler::forEachRecord(const std::string& filePath,
+                                const std::function<void(const char* begin, const char* end)>& onRecord) {
+    long long fileSize;
+#ifdef _WIN32
+    struct _stat64 info;
+    if (_stat64(filePath.c_str(), &info) != 0) {
+        throw std::runtime_error ("打开文件错误: " + filePath);
+    }
+#else
+    struct stat info;
+    if (stat(filePath.c_str(), &info) != 0) {
+        throw std::runtime_error ("打开文件错误: " + filePath);
+    }
+#endif
+    fileSize = static_cast<long long>(info.st_size);
+
+    long long validSize = 0;        // 最后一条完整记录之后的偏移
+    bool stopped = false;
+    forEachLine(filePath, [&](const char* begin, const char* end) {
+        if (stopped) {
+            return;
+        }
+        long long lineEnd = validSize + (end - begin);
+        if (lineEnd >= fileSize || !verifyRecord(begin, end)) {     // lineEnd == fileSize: 缺少换行符
+            stopped = true;
+            return;
+        }
+        onRecord(begin + RECORD_HEADER_SIZE, end);
+        validSize = lineEnd + 1;
+    });
+
+    if (validSize < fileSize) {
+        truncateFile(filePath, validSize);
+        cache.erase(filePath);
     }
-    cache[filePath] = lines;
 }
 
 bool FileHandler::isFileExist(const std::string& filePath) {
@@ -71,6 +356,19 @@ void FileHandler::clearCache(const std::string& filePath) {
     cache.erase(filePath);
 }
 
+void FileHandler::setCacheEnabled(const std::string& filePath, bool enabled) {
+    if (enabled) {
+        uncachedFiles.erase(filePath);
+    } else {
+        uncachedFiles.insert(filePath);
+        cache.erase(filePath);
+    }
+}
+
+bool FileHandler::isCacheEnabled(const std::string& filePath) const {
+    return uncachedFiles.find(filePath) == uncachedFiles.end();
+}
+
 bool FileHandler::createDirectory(const std::string& filePath) {
 #ifdef _WIN32
     std::string path = filePath;
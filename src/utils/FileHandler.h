@@ -2,13 +2,24 @@
 #define LIBRARY_MANAGEMENT_SYSTEM_FILEHANDLER_H
 
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 
 class FileHandler {
+public:
+    // 缓存中的行以不可变共享缓冲区保存, 读取命中时只增加引用计数
+    typedef std::shared_ptr<const std::vector<std::string>> SharedLines;
+
 private:
-    std::map<std::string, std::vector<std::string>> cache;
+    std::map<std::string, SharedLines> cache;
+    std::set<std::string> uncachedFiles;        // 关闭缓存的文件
+
+    void writeLines(const std::string& filePath, const std::vector<std::string>& lines);
+    static void truncateFile(const std::string& filePath, long long size);
 
 public:
     // 构造函数
@@ -16,12 +27,28 @@ public:
 
     // 方法
     std::vector<std::string> readCSV(const std::string& filePath);
+    SharedLines readCSVShared(const std::string& filePath);         // 与缓存共享, 不拷贝
+    // 流式读取: 按块读入文件, 对每一行回调 [begin, end) (不含换行符), 不经过缓存
+    void forEachLine(const std::string& filePath,
+                     const std::function<void(const char* begin, const char* end)>& onLine);
     void writeCSV(const std::string& filePath, const std::vector<std::string>& lines);
+    void writeCSV(const std::string& filePath, std::vector<std::string>&& lines);   // 需缓存时直接接管 lines
+    // 日志记录: 每条写作一行 "<CRC32 十六进制 8 位> <内容>\n", 内容中不得含换行符
+    void appendRecord(const std::string& filePath, const std::string& record);     // 追加一条并同步到磁盘
+    void appendRecords(const std::string& filePath, const std::vector<std::string>& records);   // 追加多条, 只同步一次
+    // 按顺序对每条校验通过的记录回调 [begin, end) (不含校验码); 遇到第一条校验失败或缺少换行符的记录即停止,
+    // 并把文件截断到最后一条完整记录之后, 使之后的追加不会与崩溃留下的半条记录连成一行
+    void forEachRecord(const std::string& filePath,
+                       const std::function<void(const char* begin, const char* end)>& onRecord);
     bool isFileExist(const std::string& filePath);
     void createFileIfNotExist(const std::string& filePath);
     void clearCache();
     void clearCache(const std::string& filePath);
 
+    // 按文件配置缓存 (默认开启); 已将数据解析为对象的管理器应为其数据文件关闭缓存
+    void setCacheEnabled(const std::string& filePath, bool enabled);
+    bool isCacheEnabled(const std::string& filePath) const;
+
     bool createDirectory(const std::string& filePath);             // 创建目录
 };
 
@@ -0,0 +1,68 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_PAGINATION_H
+#define LIBRARY_MANAGEMENT_SYSTEM_PAGINATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 分页结果: 只含指向管理器内部数据的指针, 在下一次修改前有效
+template<typename T>
+struct Page {
+    std::vector<const T*> items;
+    size_t offset = 0;          // 本页第一条在排序结果中的位置
+    size_t total = 0;           // 总条数
+    std::string nextCursor;     // 本页最后一条的主键, 传给 ...PageAfter 取下一页; 为空表示已是最后一页
+};
+
+// 分页助手
+// sortOrder = 0 --> 存储顺序 (默认)
+// sortOrder = 1 --> 按主键升序
+// order 为按主键排好序的行下标, 存储顺序时传 nullptr
+namespace Pagination {
+    // 取排序结果中 [start, start + limit) 组成一页
+    template<typename T, typename KeyGetter>
+    Page<T> makePage(const std::vector<T>& rows, const std::vector<size_t>* order,
+                     size_t start, size_t limit, KeyGetter key) {
+        Page<T> page;
+        page.total = rows.size();
+        page.offset = std::min(start, rows.size());
+        size_t end = page.offset + std::min(limit, rows.size() - page.offset);
+
+        page.items.reserve(end - page.offset);
+        for (size_t i = page.offset; i < end; i++) {
+            page.items.push_back(&rows[order ? (*order)[i] : i]);
+        }
+        if (end < rows.size() && !page.items.empty()) {
+            page.nextCursor = (page.items.back()->*key)();
+        }
+        return page;
+    }
+
+    // 按主键排序的行下标 (主键获取器返回引用, 先各取一次地址, 比较时不再经过获取器)
+    template<typename T, typename KeyGetter>
+    void sortByKey(const std::vector<T>& rows, KeyGetter key, std::vector<size_t>& order) {
+        std::vector<const std::string*> keys;
+        keys.reserve(rows.size());
+        order.resize(rows.size());
+        for (size_t i = 0; i < rows.size(); i++) {
+            keys.push_back(&(rows[i].*key)());
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return *keys[a] < *keys[b];
+        });
+    }
+
+    // 主键排序中第一个大于 cursor 的位置
+    template<typename T, typename KeyGetter>
+    size_t positionAfter(const std::vector<T>& rows, const std::vector<size_t>& order,
+                         const std::string& cursor, KeyGetter key) {
+        auto it = std::upper_bound(order.begin(), order.end(), cursor, [&](const std::string& value, size_t slot) {
+            return value < (rows[slot].*key)();
+        });
+        return static_cast<size_t>(it - order.begin());
+    }
+}
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_PAGINATION_H
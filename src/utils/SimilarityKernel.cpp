@@ -0,0 +1,102 @@
+// SimilarityKernel.h 实现
+
+#include "SimilarityKernel.h"
+
+// GCC/Clang 在 x86 上同时编译 SSE 与 AVX2 版本, 运行时按 CPU 选择, 不依赖 -mavx2 之类的编译选项
+// MSVC x64 总能使用 SSE2, 只有以 /arch:AVX2 编译时才使用 AVX2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define SIMILARITY_KERNEL_SSE 1
+    #define SIMILARITY_KERNEL_AVX2 1
+    #define SIMILARITY_KERNEL_TARGET_SSE __attribute__((target("sse2")))
+    #define SIMILARITY_KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #include <immintrin.h>
+    #define SIMILARITY_KERNEL_SSE 1
+    #define SIMILARITY_KERNEL_TARGET_SSE
+    #ifdef __AVX2__
+        #define SIMILARITY_KERNEL_AVX2 1
+        #define SIMILARITY_KERNEL_TARGET_AVX2
+    #endif
+#endif
+
+namespace {
+    typedef void (*Kernel)(const float* const*, const float*, size_t, size_t, float*);
+
+    // 从 begin 行起的剩余行逐个计算
+    void scalarRows(const float* const* columns, const float* weights,
+                    size_t columnCount, size_t begin, size_t rows, float* out) {
+        for (size_t r = begin; r < rows; r++) {
+            float sum = 0.0f;
+            for (size_t c = 0; c < columnCount; c++) {
+                sum += weights[c] * columns[c][r];
+            }
+            out[r] = sum;
+        }
+    }
+
+#ifndef SIMILARITY_KERNEL_SSE
+    void scalarKernel(const float* const* columns, const float* weights,
+                      size_t columnCount, size_t rows, float* out) {
+        scalarRows(columns, weights, columnCount, 0, rows, out);
+    }
+#endif
+
+#ifdef SIMILARITY_KERNEL_SSE
+    SIMILARITY_KERNEL_TARGET_SSE
+    void sseKernel(const float* const* columns, const float* weights,
+                   size_t columnCount, size_t rows, float* out) {
+        size_t r = 0;
+        for (; r + 4 <= rows; r += 4) {
+            __m128 sum = _mm_setzero_ps();
+            for (size_t c = 0; c < columnCount; c++) {
+                __m128 product = _mm_mul_ps(_mm_set1_ps(weights[c]), _mm_loadu_ps(columns[c] + r));
+                sum = _mm_add_ps(sum, product);
+            }
+            _mm_storeu_ps(out + r, sum);
+        }
+        scalarRows(columns, weights, columnCount, r, rows, out);
+    }
+#endif
+
+#ifdef SIMILARITY_KERNEL_AVX2
+    SIMILARITY_KERNEL_TARGET_AVX2
+    void avx2Kernel(const float* const* columns, const float* weights,
+                    size_t columnCount, size_t rows, float* out) {
+        size_t r = 0;
+        for (; r + 8 <= rows; r += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (size_t c = 0; c < columnCount; c++) {
+                __m256 product = _mm256_mul_ps(_mm256_set1_ps(weights[c]), _mm256_loadu_ps(columns[c] + r));
+                sum = _mm256_add_ps(sum, product);
+            }
+            _mm256_storeu_ps(out + r, sum);
+        }
+        scalarRows(columns, weights, columnCount, r, rows, out);
+    }
+#endif
+
+    Kernel select() {
+#if defined(SIMILARITY_KERNEL_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return avx2Kernel;
+        }
+#elif defined(SIMILARITY_KERNEL_AVX2)
+        return avx2Kernel;
+#endif
+#ifdef SIMILARITY_KERNEL_SSE
+        return sseKernel;
+#else
+        return scalarKernel;
+#endif
+    }
+}
+
+namespace SimilarityKernel {
+    void weightedColumnSum(const float* const* columns, const float* weights,
+                           size_t columnCount, size_t rows, float* out) {
+        static const Kernel kernel = select();
+        kernel(columns, weights, columnCount, rows, out);
+    }
+}
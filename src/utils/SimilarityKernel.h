@@ -0,0 +1,16 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_SIMILARITYKERNEL_H
+#define LIBRARY_MANAGEMENT_SYSTEM_SIMILARITYKERNEL_H
+
+#include <cstddef>
+
+// 相似度计算核心: 一个查询向量与按列 (SoA) 存放的所有行逐行求点积
+// columns[c][r] 为第 r 行的第 c 维, 同一维的所有行连续存放, 因此一条指令可同时处理 4 行 (SSE) 或 8 行 (AVX2)
+// 行已归一化时点积即余弦相似度
+namespace SimilarityKernel {
+    // out[r] = Σ weights[c] * columns[c][r], r ∈ [0, rows)
+    // 首次调用时按 CPU 选择 AVX2 / SSE / 标量实现; 各实现按相同顺序逐维累加且不使用 FMA, 结果逐位一致
+    void weightedColumnSum(const float* const* columns, const float* weights,
+                           size_t columnCount, size_t rows, float* out);
+}
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_SIMILARITYKERNEL_H
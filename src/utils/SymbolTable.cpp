@@ -0,0 +1,94 @@
+// SymbolTable.h 实现
+
+#include "SymbolTable.h"
+#include <cstring>
+#include <stdexcept>
+
+constexpr Symbol SymbolTable::EMPTY;
+constexpr Symbol SymbolTable::NOT_FOUND;
+
+SymbolTable& SymbolTable::getInstance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+SymbolTable::SymbolTable() : slots(1024, 0) {
+    intern("", 0);          // 句柄 0 固定为空串
+}
+
+// FNV-1a
+uint64_t SymbolTable::hash(const char* data, size_t size) {
+    uint64_t value = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+size_t SymbolTable::probe(const char* data, size_t size, uint64_t hashValue) const {
+    size_t mask = slots.size() - 1;
+    size_t pos = static_cast<size_t>(hashValue) & mask;
+    while (slots[pos] != 0) {
+        const std::string& candidate = strings[slots[pos] - 1];
+        if (candidate.size() == size && (size == 0 || std::memcmp(candidate.data(), data, size) == 0)) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+// 装载率超过一半时容量翻倍并重新放置所有句柄
+void SymbolTable::grow() {
+    std::vector<Symbol> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, 0);
+    for (Symbol entry : old) {
+        if (entry == 0) {
+            continue;
+        }
+        const std::string& value = strings[entry - 1];
+        slots[probe(value.data(), value.size(), hash(value.data(), value.size()))] = entry;
+    }
+}
+
+Symbol SymbolTable::intern(const char* data, size_t size) {
+    uint64_t hashValue = hash(data, size);
+    size_t pos = probe(data, size, hashValue);
+    if (slots[pos] != 0) {
+        return slots[pos] - 1;
+    }
+    if (strings.size() >= NOT_FOUND - 1) {
+        throw std::runtime_error("字符串驻留表已满");
+    }
+
+    Symbol symbol = static_cast<Symbol>(strings.size());
+    strings.emplace_back(data, size);
+    slots[pos] = symbol + 1;
+    if (strings.size() * 2 > slots.size()) {
+        grow();
+    }
+    return symbol;
+}
+
+Symbol SymbolTable::intern(const std::string& text) {
+    return intern(text.data(), text.size());
+}
+
+Symbol SymbolTable::find(const char* data, size_t size) const {
+    size_t pos = probe(data, size, hash(data, size));
+    return slots[pos] != 0 ? slots[pos] - 1 : NOT_FOUND;
+}
+
+Symbol SymbolTable::find(const std::string& text) const {
+    return find(text.data(), text.size());
+}
+
+const std::string& SymbolTable::text(Symbol symbol) const {
+    return strings[symbol];
+}
+
+size_t SymbolTable::size() const {
+    return strings.size();
+}
@@ -0,0 +1,53 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_SYMBOLTABLE_H
+#define LIBRARY_MANAGEMENT_SYSTEM_SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// 驻留字符串的句柄: 同一字符串在进程内总是得到同一个句柄, 比较与散列都是整数运算
+typedef uint32_t Symbol;
+
+// 字符串驻留表: ISBN、会员 ID、类别等标识符全局只保存一份, 模型和索引中只存 4 字节句柄
+// 句柄只在进程内有效, 不写入文件; CSV、快照和界面仍以字符串为准
+// 驻留的字符串不会释放, 条目数取决于不同标识符的个数, 与交易行数无关
+// 与各管理器一样按单线程使用设计
+class SymbolTable {
+public:
+    static constexpr Symbol EMPTY = 0;              // 空串的句柄, 默认构造的模型无需查表
+    static constexpr Symbol NOT_FOUND = UINT32_MAX; // find 未找到时的返回值
+
+    // 单例方法
+    static SymbolTable& getInstance();
+
+    // 禁止复制
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // 取得字符串的句柄, 不存在时加入表中
+    Symbol intern(const char* data, size_t size);
+    Symbol intern(const std::string& text);
+
+    // 只查不插, 不存在时返回 NOT_FOUND; 用于按用户输入查询, 避免未知键让表增长
+    Symbol find(const char* data, size_t size) const;
+    Symbol find(const std::string& text) const;
+
+    // 句柄 -> 字符串; 引用在进程内一直有效
+    const std::string& text(Symbol symbol) const;
+
+    size_t size() const;
+
+private:
+    SymbolTable();
+
+    std::deque<std::string> strings;    // 按句柄保存字符串; deque 追加时不移动已有元素
+    std::vector<Symbol> slots;          // 开放寻址散列表 (线性探测), 保存 句柄 + 1, 0 为空槽
+
+    static uint64_t hash(const char* data, size_t size);
+    size_t probe(const char* data, size_t size, uint64_t hashValue) const;     // 命中的槽或应插入的空槽
+    void grow();
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_SYMBOLTABLE_H
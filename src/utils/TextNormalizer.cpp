@@ -0,0 +1,196 @@
+// TextNormalizer.h 实现
+
+#include "TextNormalizer.h"
+#include <algorithm>
+
+namespace {
+    // 助手: 解码一个 UTF-8 码位, 返回其字节数; 非法序列返回 0
+    size_t decode(const unsigned char* p, const unsigned char* end, uint32_t& codePoint) {
+        unsigned char lead = p[0];
+        size_t length;
+        uint32_t minimum;
+        if (lead < 0x80) {
+            codePoint = lead;
+            return 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = lead & 0x1F;
+            minimum = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = lead & 0x0F;
+            minimum = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = lead & 0x07;
+            minimum = 0x10000;
+        } else {
+            return 0;
+        }
+
+        if (static_cast<size_t>(end - p) < length) {
+            return 0;
+        }
+        for (size_t i = 1; i < length; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return 0;
+            }
+            codePoint = (codePoint << 6) | (p[i] & 0x3F);
+        }
+        // 拒绝过长编码与代理区
+        if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return 0;
+        }
+        return length;
+    }
+
+    // 助手: 编码一个码位为 UTF-8
+    void encode(uint32_t codePoint, std::string& out) {
+        if (codePoint < 0x80) {
+            out.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+}
+
+uint32_t TextNormalizer::foldCodePoint(uint32_t c) {
+    // 全角转半角
+    if (c == 0x3000) {
+        return 0x20;
+    }
+    if (c >= 0xFF01 && c <= 0xFF5E) {
+        c -= 0xFEE0;
+    }
+
+    if (c < 0x80) {
+        return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+    }
+    // 拉丁字母补充 (跳过 U+00D7 乘号)
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) {
+        return c + 32;
+    }
+    // 拉丁字母扩展 A: 大小写成对排列
+    if (c >= 0x100 && c <= 0x17F) {
+        if ((c <= 0x12F) || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177)) {
+            return c | 1;
+        }
+        if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) {
+            return (c & 1) ? c + 1 : c;
+        }
+        if (c == 0x178) {
+            return 0xFF;
+        }
+        return c;
+    }
+    // 希腊字母
+    if (c >= 0x370 && c <= 0x3FF) {
+        if (c >= 0x391 && c <= 0x3AB && c != 0x3A2) return c + 32;
+        if (c == 0x386) return 0x3AC;
+        if (c >= 0x388 && c <= 0x38A) return c + 37;
+        if (c == 0x38C) return 0x3CC;
+        if (c == 0x38E || c == 0x38F) return c + 63;
+        if (c == 0x3C2) return 0x3C3;       // 词尾 sigma
+        return c;
+    }
+    // 西里尔字母
+    if (c >= 0x400 && c <= 0x40F) {
+        return c + 80;
+    }
+    if (c >= 0x410 && c <= 0x42F) {
+        return c + 32;
+    }
+    return c;
+}
+
+void TextNormalizer::foldInto(const char* begin, const char* end, std::string& out) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(begin);
+    const unsigned char* last = reinterpret_cast<const unsigned char*>(end);
+    out.reserve(out.size() + (last - p));
+
+    while (p < last) {
+        // ASCII 快速路径
+        if (*p < 0x80) {
+            unsigned char c = *p++;
+            out.push_back(static_cast<char>((c >= 'A' && c <= 'Z') ? c + 32 : c));
+            continue;
+        }
+
+        uint32_t codePoint;
+        size_t length = decode(p, last, codePoint);
+        if (length == 0) {
+            out.push_back(static_cast<char>(*p++));
+            continue;
+        }
+        uint32_t folded = foldCodePoint(codePoint);
+        if (folded == codePoint) {
+            out.append(reinterpret_cast<const char*>(p), length);       // 未变化的码位直接复制原字节
+        } else {
+            encode(folded, out);
+        }
+        p += length;
+    }
+}
+
+std::string TextNormalizer::fold(const std::string& text) {
+    std::string out;
+    foldInto(text.data(), text.data() + text.size(), out);
+    return out;
+}
+
+void TextNormalizer::toCodePoints(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* last = p + text.size();
+    while (p < last) {
+        uint32_t codePoint;
+        size_t length = decode(p, last, codePoint);
+        if (length == 0) {
+            codePoint = *p;
+            length = 1;
+        }
+        out.push_back(codePoint);
+        p += length;
+    }
+}
+
+// 半全局编辑距离 (Levenshtein + 相邻交换, 即 OSA): pattern 必须完整匹配, text 两端可免费跳过
+// 只保留三行, 某一行的最小值已超过 limit 时后续不可能更优, 提前结束
+size_t TextNormalizer::substringEditDistance(const std::vector<uint32_t>& pattern,
+                                             const std::vector<uint32_t>& text, size_t limit) {
+    if (pattern.empty()) {
+        return 0;
+    }
+    std::vector<size_t> beforePrevious(text.size() + 1, 0);
+    std::vector<size_t> previous(text.size() + 1, 0);
+    std::vector<size_t> current(text.size() + 1);
+
+    for (size_t i = 1; i <= pattern.size(); i++) {
+        current[0] = i;
+        size_t rowMinimum = current[0];
+        for (size_t j = 1; j <= text.size(); j++) {
+            size_t substitution = previous[j - 1] + (pattern[i - 1] == text[j - 1] ? 0 : 1);
+            current[j] = std::min(substitution, std::min(previous[j], current[j - 1]) + 1);
+            if (i > 1 && j > 1 && pattern[i - 1] == text[j - 2] && pattern[i - 2] == text[j - 1]) {
+                current[j] = std::min(current[j], beforePrevious[j - 2] + 1);       // 相邻两字交换
+            }
+            rowMinimum = std::min(rowMinimum, current[j]);
+        }
+        if (rowMinimum > limit) {
+            return limit + 1;
+        }
+        beforePrevious.swap(previous);
+        previous.swap(current);
+    }
+    return *std::min_element(previous.begin(), previous.end());
+}
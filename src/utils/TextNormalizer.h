@@ -0,0 +1,31 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_TEXTNORMALIZER_H
+#define LIBRARY_MANAGEMENT_SYSTEM_TEXTNORMALIZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 搜索用文本规范化 (UTF-8)
+// - 全角 ASCII (U+FF01..U+FF5E) 转半角, 全角空格 (U+3000) 转空格
+// - 大小写折叠: ASCII、拉丁字母补充/扩展 A、希腊字母、西里尔字母
+// 中日韩文字本身无大小写, 原样保留; 非法 UTF-8 字节按原字节保留
+// 模糊搜索两侧都使用折叠后的形式比较
+namespace TextNormalizer {
+    // 折叠单个码位
+    uint32_t foldCodePoint(uint32_t codePoint);
+
+    // 折叠 [begin, end), 结果追加到 out
+    void foldInto(const char* begin, const char* end, std::string& out);
+
+    std::string fold(const std::string& text);
+
+    // 解码为码位序列; 非法字节按单个码位 (原字节值) 处理
+    void toCodePoints(const std::string& text, std::vector<uint32_t>& out);
+
+    // pattern 与 text 中任一子串之间的最小编辑距离 (按码位计, 相邻交换算一次), 用于容错匹配
+    // 超过 limit 时提前返回 limit + 1
+    size_t substringEditDistance(const std::vector<uint32_t>& pattern, const std::vector<uint32_t>& text,
+                                 size_t limit);
+}
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_TEXTNORMALIZER_H
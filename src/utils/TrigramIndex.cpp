@@ -0,0 +1,193 @@
+// TrigramIndex.h 实现
+
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+// 私有: 助手: 取三元组, 3 个字节打包为一个整数键
+void TrigramIndex::trigramsOf(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    if (text.size() < MIN_QUERY_LENGTH) {
+        return;
+    }
+    out.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); i++) {
+        out.push_back(static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16 |
+                      static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8 |
+                      static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2])));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TrigramIndex::clear() {
+    postings.clear();
+}
+
+// 加载时行下标递增, 直接追加到末尾; 否则按序插入
+void TrigramIndex::add(uint32_t slot, const std::string& text) {
+    std::vector<uint32_t> grams;
+    trigramsOf(text, grams);
+    for (uint32_t gram : grams) {
+        std::vector<uint32_t>& list = postings[gram];
+        if (list.empty() || list.back() < slot) {
+            list.push_back(slot);
+        } else {
+            auto it = std::lower_bound(list.begin(), list.end(), slot);
+            if (it == list.end() || *it != slot) {
+                list.insert(it, slot);
+            }
+        }
+    }
+}
+
+void TrigramIndex::shiftDown(uint32_t slot) {
+    for (auto& entry : postings) {
+        std::vector<uint32_t>& list = entry.second;
+        for (auto it = std::upper_bound(list.begin(), list.end(), slot); it != list.end(); ++it) {
+            --*it;
+        }
+    }
+}
+
+void TrigramIndex::remove(uint32_t slot, const std::string& text) {
+    std::vector<uint32_t> grams;
+    trigramsOf(text, grams);
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            continue;
+        }
+        std::vector<uint32_t>& list = found->second;
+        auto it = std::lower_bound(list.begin(), list.end(), slot);
+        if (it != list.end() && *it == slot) {
+            list.erase(it);
+        }
+        if (list.empty()) {
+            postings.erase(found);
+        }
+    }
+}
+
+size_t TrigramIndex::estimate(const std::string& key) const {
+    if (key.size() < MIN_QUERY_LENGTH) {
+        return SIZE_MAX;
+    }
+    std::vector<uint32_t> grams;
+    trigramsOf(key, grams);
+
+    size_t smallest = SIZE_MAX;
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            return 0;
+        }
+        smallest = std::min(smallest, found->second.size());
+    }
+    return smallest;
+}
+
+// 从最短的倒排表出发, 其余表用二分查找过滤
+bool TrigramIndex::candidates(const std::string& key, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (key.size() < MIN_QUERY_LENGTH) {
+        return false;
+    }
+
+    std::vector<uint32_t> grams;
+    trigramsOf(key, grams);
+
+    std::vector<const std::vector<uint32_t>*> lists;
+    lists.reserve(grams.size());
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            return true;        // 某个三元组从未出现, 必然无匹配
+        }
+        lists.push_back(&found->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    for (uint32_t slot : *lists[0]) {
+        bool inAll = true;
+        for (size_t i = 1; i < lists.size() && inAll; i++) {
+            inAll = std::binary_search(lists[i]->begin(), lists[i]->end(), slot);
+        }
+        if (inAll) {
+            out.push_back(slot);
+        }
+    }
+    return true;
+}
+
+// 先整表累加较短的倒排表, 直到处理量超出预算; 其余的表对每个候选二分查找
+size_t TrigramIndex::countShared(const std::string& key, size_t maxCandidates,
+                                 std::unordered_map<uint32_t, int>& counts) const {
+    std::vector<uint32_t> grams;
+    trigramsOf(key, grams);
+
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found != postings.end()) {
+            lists.push_back(&found->second);
+        }
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    size_t i = 0;
+    size_t scanned = 0;
+    for (; i < lists.size(); i++) {
+        if (scanned + lists[i]->size() > maxCandidates) {
+            break;
+        }
+        for (uint32_t slot : *lists[i]) {
+            counts[slot]++;
+        }
+        scanned += lists[i]->size();
+    }
+
+    // 连最短的表都超出预算: 所有三元组都很常见. 从最短的表起依次与次短的表求交, 直到候选不超过预算,
+    // 留下的是同时含有最罕见的几个三元组的行, 与其在目录中的位置无关.
+    // 召回上的代价: 只与查询共有较常见三元组、却缺少某个罕见三元组的行 (例如错字恰好落在罕见三元组上) 不再成为候选;
+    // 求交会清空候选的表多半来自查询中的错字, 跳过它, 留给下面的二分查找计数
+    std::vector<const std::vector<uint32_t>*> remaining(lists.begin() + i, lists.end());
+    if (i == 0 && !lists.empty()) {
+        std::vector<uint32_t> survivors(*lists[0]);
+        std::vector<uint32_t> narrowed;
+        int shared = 1;
+        remaining.clear();
+        for (size_t k = 1; k < lists.size(); k++) {
+            if (survivors.size() <= maxCandidates) {
+                remaining.push_back(lists[k]);
+                continue;
+            }
+            narrowed.clear();
+            std::set_intersection(survivors.begin(), survivors.end(), lists[k]->begin(), lists[k]->end(),
+                                  std::back_inserter(narrowed));
+            if (narrowed.empty()) {
+                remaining.push_back(lists[k]);
+                continue;
+            }
+            survivors.swap(narrowed);
+            shared++;
+        }
+        // 仍超出预算时这些行含有同样的三元组, 无从区分, 在整个范围内等距抽取
+        size_t stride = (survivors.size() + maxCandidates - 1) / std::max<size_t>(maxCandidates, 1);
+        for (size_t k = 0; k < survivors.size(); k += stride) {
+            counts[survivors[k]] += shared;
+        }
+    }
+
+    for (const std::vector<uint32_t>* list : remaining) {
+        for (auto& entry : counts) {
+            if (std::binary_search(list->begin(), list->end(), entry.first)) {
+                entry.second++;
+            }
+        }
+    }
+    return grams.size();
+}
@@ -0,0 +1,42 @@
+#ifndef LIBRARY_MANAGEMENT_SYSTEM_TRIGRAMINDEX_H
+#define LIBRARY_MANAGEMENT_SYSTEM_TRIGRAMINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 三元组倒排索引: 文本中每个连续 3 字节 -> 包含它的行下标
+// 子串查询先对各三元组的倒排表求交得到候选行, 再由调用方逐行核对
+// 按字节切分, UTF-8 文本同样适用; 行下标在倒排表中按升序保存
+// 索引本身不做大小写处理, 建索引与查询两侧须传入同样规范化 (TextNormalizer::fold) 后的文本
+class TrigramIndex {
+private:
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+
+    // 助手: 取 text 的全部三元组 (去重)
+    static void trigramsOf(const std::string& text, std::vector<uint32_t>& out);
+
+public:
+    static const size_t MIN_QUERY_LENGTH = 3;   // 短于此长度的查询无法使用索引
+
+    void clear();
+    void add(uint32_t slot, const std::string& text);
+    void remove(uint32_t slot, const std::string& text);
+    void shiftDown(uint32_t slot);      // 删除行 slot 后, 其后各行下标减一; 调用前应已 remove 该行
+
+    // 估计包含 key 的行数上限 (最短倒排表的长度), 用于在多个索引间选择; key 过短时返回 SIZE_MAX
+    size_t estimate(const std::string& key) const;
+
+    // 按升序返回可能包含 key 的行下标; key 过短时返回 false, 调用方应退回全表扫描
+    bool candidates(const std::string& key, std::vector<uint32_t>& out) const;
+
+    // 相似度检索: 统计各行与 key 共有的三元组个数, 累加到 counts (行下标 -> 个数)
+    // 候选行最多 maxCandidates 个, 由最短 (最有区分度) 的倒排表产生, 较长的表只为已有候选计数,
+    // 因此耗时只取决于候选数而非表大小; 连最短的表也超出预算时, 以几个最罕见三元组倒排表的交集为候选 (求交耗时与表长成线性)
+    // 返回 key 的三元组个数
+    size_t countShared(const std::string& key, size_t maxCandidates,
+                       std::unordered_map<uint32_t, int>& counts) const;
+};
+
+#endif //LIBRARY_MANAGEMENT_SYSTEM_TRIGRAMINDEX_H